@@ -24,16 +24,33 @@ CXXWARN="-Wall -Wextra -Wattributes -Wbuiltin-macro-redefined -Wcast-align -Wcon
 CFLAGS="$CFLAGS -std=c++11"
 DEBUG_FLAGS="$CXXWARN -O0 -g -DDEBUG"
 RELEASE_FLAGS="-Os"
-if [[ $1 = "release" ]]; then
+if [[ $1 = "release" || $1 = "headless" || $1 = "batch" || $1 = "nullgl" || $1 = "bench" ]]; then
 	CFLAGS="$CFLAGS $RELEASE_FLAGS"
 else
 	CFLAGS="$CFLAGS $DEBUG_FLAGS"
 fi
-LDFLAGS="-Lbuild"
+LDFLAGS="-Lbuild -pthread"
+CFLAGS="$CFLAGS -pthread" # track generation runs on a worker thread
 
 # gamelib
 INCLUDE_DIRS="-Ilib/gamelib/src"
 
+# simulation only, needs neither SDL nor OpenGL
+if [[ $1 = "headless" ]]; then
+	mkdir -p build
+	echo "compiling headless..."
+	c++ $CFLAGS $INCLUDE_DIRS src/main_headless.cpp $LDFLAGS -o build/${TARGET}_headless
+	exit $?
+fi
+
+# many headless games with the autopilot on all cores, for balance sweeps
+if [[ $1 = "batch" ]]; then
+	mkdir -p build
+	echo "compiling batch..."
+	c++ $CFLAGS $INCLUDE_DIRS src/main_batch.cpp $LDFLAGS -o build/${TARGET}_batch
+	exit $?
+fi
+
 # zlib
 CFLAGS="$CFLAGS -DUSE_ZLIB"
 LIB_Z="-lz"
@@ -47,6 +64,30 @@ LIB_OPENGL="-lGL"
 # fontstash
 INCLUDE_DIRS="$INCLUDE_DIRS -Ilib/fontstash"
 LIB_FONTSTASH="-lfontstash"
+
+# game and renderer against the null gl backend, needs neither SDL nor a gl driver
+# fontstash is compiled in so its gl calls end up in src/gl_null.cpp as well
+if [[ $1 = "nullgl" ]]; then
+	mkdir -p build
+	if [[ ! -d build/data ]]; then
+		python compile_assets.py assets build/data desktop
+	fi
+	echo "compiling nullgl..."
+	c++ $CFLAGS -DLINUX_DESKTOP $INCLUDE_DIRS src/main_nullgl.cpp lib/gamelib/third_party/fontstash/fontstash.cpp $LDFLAGS $LIB_Z -o build/${TARGET}_nullgl
+	exit $?
+fi
+
+# microbenchmarks of the simulation and the track mesh as JSON, also against the null gl backend
+if [[ $1 = "bench" ]]; then
+	mkdir -p build
+	if [[ ! -d build/data ]]; then
+		python compile_assets.py assets build/data desktop
+	fi
+	echo "compiling bench..."
+	c++ $CFLAGS -DLINUX_DESKTOP $INCLUDE_DIRS src/main_bench.cpp $LDFLAGS $LIB_Z -o build/${TARGET}_bench
+	exit $?
+fi
+
 if [ ! -f build/libfontstash.a ]; then
 	echo "building fontstash..."
 	./build_fontstash.sh
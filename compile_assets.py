@@ -6,9 +6,15 @@ This will process all the stuff in the assets dir and put it in the data dir
 
 import os
 from shutil import copyfile
+import hashlib
+import json
+from multiprocessing import cpu_count
+from multiprocessing.pool import ThreadPool
 import platform
+import struct
 import subprocess
 import sys
+import threading
 import time
 
 
@@ -37,6 +43,7 @@ else:
 
 export_model_script = "scripts/blender/export_model.py"
 export_level_script = "scripts/blender/export_level.py"
+model_mdl_script = "scripts/blender/model_mdl.py" # imported by both export scripts
 
 
 
@@ -54,6 +61,20 @@ def setTGAOriginTop(filename):
 	f.write(b'\x20')
 	f.close()
 
+def hashFile(filename, h):
+	with open(filename, "rb") as f:
+		while True:
+			chunk = f.read(1 << 20)
+			if not chunk:
+				break
+			h.update(chunk)
+
+print_lock = threading.Lock()
+def log(message):
+	with print_lock:
+		print(message)
+		sys.stdout.flush()
+
 
 
 # make sure out dir exists
@@ -61,6 +82,46 @@ makeDirIfNotExists(dst_dirname)
 
 
 
+# every output is built by one job, jobs are independent of each other
+# a job's key hashes its inputs, the scripts it runs and its command line
+# only jobs whose key differs from the one in the manifest are run again
+jobs = []
+
+def addJob(message, dst_filename, src_filenames, scripts=[], command=None, post=None):
+	jobs.append({
+		"message": message,
+		"dst": dst_filename,
+		"srcs": src_filenames,
+		"scripts": scripts,
+		"command": command, # None copies the first source
+		"post": post, # called with dst_filename after the command succeeded
+	})
+
+def jobKey(job):
+	h = hashlib.sha1()
+	h.update(json.dumps(job["command"]).encode("utf-8"))
+	for filename in job["scripts"] + job["srcs"]:
+		h.update(filename.encode("utf-8"))
+		hashFile(filename, h)
+	return h.hexdigest()
+
+def runJob(job):
+	log(job["message"])
+	dst_filename = job["dst"]
+	if job["command"] is None:
+		copyfile(job["srcs"][0], dst_filename)
+	elif subprocess.call(job["command"]) != 0:
+		log("failed: "+job["message"])
+		return False
+	if not os.path.exists(dst_filename):
+		log("no output: "+dst_filename)
+		return False
+	if job["post"]:
+		job["post"](dst_filename)
+	return True
+
+
+
 # process 3D models (props and characters)
 makeDirIfNotExists(dst_dirname+"/models")
 
@@ -71,16 +132,9 @@ for model in os.listdir(src_dirname+"/models"):
 	src_model_filename = src_dirname+"/models/"+model
 	dst_model_filename = dst_dirname+"/models/"+os.path.splitext(model)[0]+".mdl"
 
-	do_compile_model = False
-	if os.path.exists(dst_model_filename):
-		do_compile_model = isFileNewer(src_model_filename, dst_model_filename)
-	else:
-		do_compile_model = True
-	#do_compile_model = True # for debugging
-
-	if do_compile_model:
-		print("compiling "+src_model_filename)
-		subprocess.call([blender_bin, "-b", src_model_filename, "-P", export_model_script, "--", "--out", dst_model_filename, "--use_16bit_indices"])
+	addJob("compiling "+src_model_filename, dst_model_filename, [src_model_filename],
+		[export_model_script, model_mdl_script],
+		[blender_bin, "-b", src_model_filename, "-P", export_model_script, "--", "--out", dst_model_filename, "--use_16bit_indices"])
 
 
 
@@ -97,39 +151,25 @@ if os.path.exists(src_dirname+"/levels"):
 				print("blend file for level "+level+" not found")
 				continue
 
-			do_compile_level = False
-			if not os.path.exists(dst_level_dir):
-				os.mkdir(dst_level_dir)
-				do_compile_level = True
-			else:
-				if os.path.exists(dst_level_filename):
-					do_compile_level = isFileNewer(src_level_filename, dst_level_filename)
-				else:
-					do_compile_level = True
-
-			if do_compile_level:
-				print("compiling "+src_level_filename)
-				subprocess.call([blender_bin, "-b", src_level_filename, "-P", export_level_script, "--", "--out", dst_level_dir, "--use_16bit_indices"])
-
-# always compile test level (testing export script)
-#subprocess.call([blender_bin, "-b", src_dirname+"/levels/dust/dust.blend", "-P", export_level_script, "--", "--out", dst_dirname+"/levels/dust", "--use_16bit_indices"])
+			makeDirIfNotExists(dst_level_dir)
+			addJob("compiling "+src_level_filename, dst_level_filename, [src_level_filename],
+				[export_level_script, model_mdl_script],
+				[blender_bin, "-b", src_level_filename, "-P", export_level_script, "--", "--out", dst_level_dir, "--use_16bit_indices"])
 
 # compress textures
-makeDirIfNotExists(dst_dirname+"/textures")
-
-for texture in os.listdir(src_dirname+"/textures"):
-	src_texture_filename = src_dirname+"/textures/"+texture
-	if target_platform == "pandora":
-		dst_texture_filename = dst_dirname+"/textures/"+os.path.splitext(texture)[0]+".pvr"
-	else:
-		dst_texture_filename = dst_dirname+"/textures/"+os.path.splitext(texture)[0]+".dds"
+if os.path.exists(src_dirname+"/textures"):
+	makeDirIfNotExists(dst_dirname+"/textures")
 
-	if not os.path.exists(dst_texture_filename) or isFileNewer(src_texture_filename, dst_texture_filename):
-		print("compressing "+texture)
+	for texture in os.listdir(src_dirname+"/textures"):
+		src_texture_filename = src_dirname+"/textures/"+texture
 		if target_platform == "pandora":
-			subprocess.call([pvrtextool_bin, "-m", "-q", "pvrtcbest", "-f", "PVRTC1_4_RGB", "-i", src_texture_filename, "-o", dst_texture_filename])
+			dst_texture_filename = dst_dirname+"/textures/"+os.path.splitext(texture)[0]+".pvr"
+			addJob("compressing "+texture, dst_texture_filename, [src_texture_filename], command=
+				[pvrtextool_bin, "-m", "-q", "pvrtcbest", "-f", "PVRTC1_4_RGB", "-i", src_texture_filename, "-o", dst_texture_filename])
 		else:
-			subprocess.call([nvtextool_bin, "-silent", src_texture_filename, dst_texture_filename])
+			dst_texture_filename = dst_dirname+"/textures/"+os.path.splitext(texture)[0]+".dds"
+			addJob("compressing "+texture, dst_texture_filename, [src_texture_filename], command=
+				[nvtextool_bin, "-silent", src_texture_filename, dst_texture_filename])
 
 
 # convert ui graphics into tga format using imagemagick
@@ -140,11 +180,9 @@ if os.path.exists(src_dirname+"/gfx"):
 		src_gfx_filename = src_dirname+"/gfx/"+gfx
 		dst_gfx_filename = dst_dirname+"/gfx/"+os.path.splitext(gfx)[0]+".tga"
 
-		if not os.path.exists(dst_gfx_filename) or isFileNewer(src_gfx_filename, dst_gfx_filename):
-			print("converting "+gfx)
-			subprocess.call(["convert", "-strip", src_gfx_filename, "-flip", "-type", "truecolormatte", dst_gfx_filename])
-			setTGAOriginTop(dst_gfx_filename)
-			#subprocess.call(["sh", "scripts/set_tga_origin_top.sh", dst_gfx_filename])
+		addJob("converting "+gfx, dst_gfx_filename, [src_gfx_filename], command=
+			["convert", "-strip", src_gfx_filename, "-flip", "-type", "truecolormatte", dst_gfx_filename],
+			post=setTGAOriginTop)
 
 # copy truetype fonts
 fontlist = ["OpenSans/LICENSE.txt", "OpenSans/OpenSans-Regular.ttf"]
@@ -153,7 +191,99 @@ for font in fontlist:
 	dst_font_filename = dst_dirname+"/fonts/"+font
 
 	makeDirIfNotExists(os.path.dirname(dst_font_filename))
-
-	if not os.path.exists(dst_font_filename) or isFileNewer(src_font_filename, dst_font_filename):
-		print("copying "+src_font_filename+" to "+dst_font_filename)
-		copyfile(src_font_filename, dst_font_filename)
+	addJob("copying "+src_font_filename+" to "+dst_font_filename, dst_font_filename, [src_font_filename])
+
+
+
+# run the jobs whose key changed, the manifest lives next to the data dir so it isn't packed
+manifest_filename = dst_dirname.rstrip("/")+".manifest.json"
+manifest = {}
+if os.path.exists(manifest_filename):
+	try:
+		with open(manifest_filename, "r") as f:
+			manifest = json.load(f)
+	except ValueError:
+		print("ignoring broken manifest "+manifest_filename)
+
+stale_jobs = []
+new_manifest = {}
+for job in jobs:
+	job["key"] = jobKey(job)
+	if os.path.exists(job["dst"]) and manifest.get(job["dst"]) == job["key"]:
+		new_manifest[job["dst"]] = job["key"]
+	else:
+		stale_jobs.append(job)
+
+if stale_jobs:
+	pool = ThreadPool(min(cpu_count(), len(stale_jobs))) # the work happens in subprocesses
+	results = pool.map(runJob, stale_jobs)
+	pool.close()
+	pool.join()
+	for job, succeeded in zip(stale_jobs, results):
+		if succeeded: # failed ones are retried next time
+			new_manifest[job["dst"]] = job["key"]
+
+with open(manifest_filename, "w") as f:
+	json.dump(new_manifest, f, indent=1, sort_keys=True)
+
+
+
+# pack everything into one archive next to the data dir, the game memory-maps it (see src/asset_archive.h)
+archive_filename = dst_dirname.rstrip("/")+".pak"
+archive_alignment = 16
+archive_name_size = 56
+archive_header_format = "4s3I" # magic, version, entry count, unused
+archive_entry_format = "%dsx2I" % (archive_name_size-1) # name, offset, size
+
+asset_names = []
+for dirpath, dirnames, filenames in os.walk(dst_dirname):
+	for filename in filenames:
+		name = os.path.relpath(os.path.join(dirpath, filename), dst_dirname).replace(os.sep, "/")
+		if len(name.encode("utf-8")) >= archive_name_size:
+			print("asset name too long for the archive: "+name)
+			continue
+		asset_names.append(name)
+asset_names.sort(key=lambda name: name.encode("utf-8")) # the game does a binary search with strncmp
+
+def readArchiveNames(filename):
+	with open(filename, "rb") as f:
+		header = f.read(struct.calcsize(archive_header_format))
+		if len(header) != struct.calcsize(archive_header_format):
+			return None
+		magic, version, entry_count, unused = struct.unpack(archive_header_format, header)
+		if magic != b"PAK1" or version != 1:
+			return None
+		names = []
+		for i in range(entry_count):
+			entry = f.read(struct.calcsize(archive_entry_format))
+			if len(entry) != struct.calcsize(archive_entry_format):
+				return None
+			name, offset, size = struct.unpack(archive_entry_format, entry)
+			names.append(name.split(b"\0", 1)[0].decode("utf-8"))
+		return names
+
+# also when assets were added or deleted, their mtimes don't tell
+do_pack = not os.path.exists(archive_filename) or readArchiveNames(archive_filename) != asset_names
+for name in asset_names:
+	if do_pack:
+		break
+	do_pack = isFileNewer(dst_dirname+"/"+name, archive_filename)
+
+if do_pack:
+	print("packing "+archive_filename)
+	offset = struct.calcsize(archive_header_format) + struct.calcsize(archive_entry_format)*len(asset_names)
+	entries = b""
+	blobs = b""
+	for name in asset_names:
+		padding = (archive_alignment - offset % archive_alignment) % archive_alignment
+		blobs += padding*b"\0"
+		offset += padding
+		with open(dst_dirname+"/"+name, "rb") as f:
+			blob = f.read()
+		entries += struct.pack(archive_entry_format, name.encode("utf-8"), offset, len(blob))
+		blobs += blob
+		offset += len(blob)
+	with open(archive_filename, "wb") as f:
+		f.write(struct.pack(archive_header_format, b"PAK1", 1, len(asset_names), 0))
+		f.write(entries)
+		f.write(blobs)
@@ -0,0 +1,82 @@
+AssetArchive asset_archive;
+
+bool AssetArchive::open(const char *filename) {
+	close();
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0) return false; // loose files only
+	struct stat st;
+	void *mapping = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && st.st_size >= 16) {
+		mapping = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	::close(fd); // the mapping stays valid
+	if (mapping == MAP_FAILED) {
+		LOGE("Could not map asset archive: %s", filename);
+		return false;
+	}
+	data = (const u8*)mapping;
+	size = (size_t)st.st_size;
+
+	u32 header[4]; // magic, version, entry count, unused
+	memcpy(header, data, sizeof(header));
+	if (memcmp(data, "PAK1", 4) != 0 || header[1] != ASSET_ARCHIVE_VERSION ||
+		16 + (size_t)header[2] * sizeof(AssetArchiveEntry) > size)
+	{
+		LOGE("Not an asset archive: %s", filename);
+		close();
+		return false;
+	}
+	entries = (const AssetArchiveEntry*)(data + 16);
+	entry_count = header[2];
+	LOGI("asset archive %s: %u assets, %.1f KB", filename, entry_count, (double)size / 1024.0);
+	return true;
+}
+
+void AssetArchive::close() {
+	if (data) munmap((void*)data, size);
+	data = nullptr;
+	size = 0;
+	entries = nullptr;
+	entry_count = 0;
+}
+
+const u8 *AssetArchive::find(const char *filename, size_t *out_size) {
+	if (strncmp(filename, "data/", 5) == 0) filename += 5;
+	// binary search, entries are sorted by name
+	u32 lo = 0, hi = entry_count;
+	while (lo < hi) {
+		u32 mid = (lo + hi) / 2;
+		int c = strncmp(entries[mid].name, filename, ASSET_ARCHIVE_NAME_SIZE);
+		if (c == 0) {
+			const AssetArchiveEntry &e = entries[mid];
+			if ((size_t)e.offset + e.size > size) return nullptr;
+			*out_size = e.size;
+			return data + e.offset;
+		}
+		if (c < 0) lo = mid + 1;
+		else hi = mid;
+	}
+	return nullptr;
+}
+
+bool AssetData::load(const char *filename) {
+	file_data.clear();
+	data = asset_archive.find(filename, &size);
+	if (data) return true;
+
+	FILE *file = fopen(filename, "rb");
+	if (!file) {
+		size = 0;
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long file_size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	file_data.resize(file_size > 0 ? (size_t)file_size : 0);
+	bool read_ok = file_data.empty() || fread(&file_data[0], 1, file_data.size(), file) == file_data.size();
+	fclose(file);
+	if (!read_ok) file_data.clear();
+	data = file_data.data();
+	size = file_data.size();
+	return read_ok;
+}
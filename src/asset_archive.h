@@ -0,0 +1,40 @@
+/*
+asset archive: everything in data/ packed into one file by compile_assets.py
+header: "PAK1", u32 version, u32 entry count, u32 unused
+entries: 56 byte zero terminated name relative to data/, u32 offset, u32 size, sorted by name
+blobs: at offsets aligned to ASSET_ARCHIVE_ALIGNMENT
+the archive is memory-mapped once and assets are used straight out of the mapping
+only gamelib's MDLModel, which the animated car needs, still reads its file from data/ itself
+*/
+
+const u32 ASSET_ARCHIVE_VERSION = 1;
+const u32 ASSET_ARCHIVE_ALIGNMENT = 16;
+const int ASSET_ARCHIVE_NAME_SIZE = 56;
+
+struct AssetArchiveEntry {
+	char name[ASSET_ARCHIVE_NAME_SIZE];
+	u32 offset; // from the start of the archive
+	u32 size;
+};
+
+struct AssetArchive {
+	const u8 *data = nullptr; // the mapping, read only
+	size_t size = 0;
+	const AssetArchiveEntry *entries = nullptr;
+	u32 entry_count = 0;
+
+	bool open(const char *filename);
+	void close();
+	const u8 *find(const char *filename, size_t *size); // null if not in the archive, "data/" is optional
+};
+
+extern AssetArchive asset_archive; // opened at startup, stays closed where there's no archive (emscripten)
+
+// an asset's bytes, from the archive if it's there, otherwise read from its file
+struct AssetData {
+	const u8 *data = nullptr;
+	size_t size = 0;
+	std::vector<u8> file_data; // only used for loose files
+
+	bool load(const char *filename);
+};
@@ -0,0 +1,62 @@
+void AssetLoader::add(void (*load)(), void (*upload)()) {
+	Job job = {load, upload};
+	_jobs.push_back(job);
+}
+
+void AssetLoader::start() {
+	_uploaded = 0;
+	_loaded = 0;
+#ifndef __EMSCRIPTEN__
+	_thread = std::thread(&AssetLoader::run, this);
+#endif
+}
+
+void AssetLoader::loadJob(Job *job) {
+	PROFILE_SCOPE("AssetLoader::loadJob");
+	if (job->load) job->load();
+}
+
+void AssetLoader::run() {
+#ifndef __EMSCRIPTEN__
+	profiler.setThreadName("asset loader");
+	for (size_t i = 0; i < _jobs.size(); i++) {
+		loadJob(&_jobs[i]);
+		_loaded.store(i + 1, std::memory_order_release);
+	}
+#endif
+}
+
+bool AssetLoader::update(double budget) {
+	auto begin = std::chrono::steady_clock::now();
+	while (_uploaded < _jobs.size()) {
+		Job &job = _jobs[_uploaded];
+#ifdef __EMSCRIPTEN__
+		loadJob(&job);
+#else
+		if (_uploaded >= _loaded.load(std::memory_order_acquire)) break; // next frame
+#endif
+		if (job.upload) {
+			PROFILE_SCOPE("AssetLoader::upload");
+			job.upload();
+		}
+		_uploaded++;
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+		if (elapsed.count() >= budget) break;
+	}
+	if (_uploaded < _jobs.size()) return false;
+#ifndef __EMSCRIPTEN__
+	if (_thread.joinable()) _thread.join();
+#endif
+	return true;
+}
+
+void AssetLoader::finish() {
+#ifndef __EMSCRIPTEN__
+	if (_thread.joinable()) _thread.join();
+#endif
+	update(INFINITY);
+}
+
+float AssetLoader::progress() {
+	return _jobs.empty() ? 1.0f : (float)_uploaded / (float)_jobs.size();
+}
@@ -0,0 +1,29 @@
+// loads the render assets over the first frames so there's something on screen right away
+// file reading and parsing runs on a worker thread, gl objects are made on the main thread within a time budget per frame
+// the car is the exception, gamelib's MDLModel reads and parses its file in upload
+class AssetLoader {
+public:
+	// in the order they are uploaded, either may be null
+	void add(void (*load)(), void (*upload)());
+	void start();
+	bool update(double budget); // main thread, seconds of uploads, true once everything is uploaded
+	void finish(); // loads and uploads whatever is left
+	float progress(); // fraction of the jobs uploaded
+
+private:
+	struct Job {
+		void (*load)(); // worker
+		void (*upload)(); // main thread
+	};
+
+	void loadJob(Job *job);
+	void run(); // worker thread
+
+	std::vector<Job> _jobs; // not changed once started
+	size_t _uploaded = 0;
+	std::atomic<size_t> _loaded{0}; // the worker loads them in order
+
+#ifndef __EMSCRIPTEN__ // no threads, jobs are loaded right before their upload
+	std::thread _thread;
+#endif
+};
@@ -0,0 +1,128 @@
+const float AUTOPILOT_MIN_SPEED = 12.0f;
+const float AUTOPILOT_SCAN_DISTANCE = 20.0f; // beyond the target, gas tanks there are already headed for
+const float AUTOPILOT_EDGE_MARGIN = 2.0f; // keeps the wheels this far from the edges
+const float AUTOPILOT_OIL_CLEARANCE = 4.5f; // oil spill radius plus half the car and some slack
+const float AUTOPILOT_STEER_DEADBAND = 0.03f; // radians
+
+// the segment d meters ahead of segment i, d becomes the distance into it
+static TrackSegment *walkSegments(Track **track, size_t *i, float *d, Track *next) {
+	for (;;) {
+		TrackSegment *s = &(*track)->segments[*i];
+		if (*d <= s->dims.y) return s;
+		if (*i + 1 < (*track)->segments.size()) {
+			*d -= s->dims.y;
+			(*i)++;
+		} else if (next && *track != next && !next->segments.empty()) {
+			*d -= s->dims.y;
+			*track = next;
+			*i = 0;
+		} else { // the finish line
+			*d = s->dims.y;
+			return s;
+		}
+	}
+}
+
+// calls f for the active pickups in front of p, from segment i of track to segment last_index of last_track
+// segment by segment, until f returns true
+template <typename F>
+static void forEachPickupAhead(Track *track, size_t i, Track *last_track, size_t last_index, Track *next, vec2 p, vec2 forward, F f) {
+	for (;;) {
+		for (u32 pi = track->segment_pickups[i]; pi < track->segment_pickups[i+1]; pi++) {
+			Pickup &pickup = track->pickups[pi];
+			if (pickup.active && dot(v2(pickup.position) - p, forward) > 0.0f && f(pickup, track->segments[i])) return;
+		}
+		if (track == last_track && i == last_index) break;
+		if (++i == track->segments.size()) {
+			track = next;
+			i = 0;
+		}
+	}
+}
+
+// moves target sideways until the line from p to it passes the oil spill at o
+static vec2 avoidOilSpill(vec2 p, vec2 target, vec2 o, TrackSegment *ts) {
+	vec2 path = target - p;
+	float path_length = length(path);
+	vec2 dir = path / path_length;
+	float along = dot(o - p, dir);
+	if (along <= 0.0f || along >= path_length) return target;
+	vec2 n = v2(-dir.y, dir.x);
+	float off = dot(o - p, n);
+	if (fabsf(off) >= AUTOPILOT_OIL_CLEARANCE) return target;
+
+	// pass on either side, shifting the target moves the path at the spill by along/path_length of it
+	float scale = path_length / along;
+	float shifts[2] = {(off - AUTOPILOT_OIL_CLEARANCE) * scale, (off + AUTOPILOT_OIL_CLEARANCE) * scale};
+	float max_lateral = 0.5f * ts->dims.x - AUTOPILOT_EDGE_MARGIN;
+	float target_lateral = dot(target - ts->p, ts->t);
+	float best_shift = 0.0f;
+	float best_cost = FLT_MAX;
+	for (int k = 0; k < 2; k++) {
+		float lateral = target_lateral + shifts[k] * dot(n, ts->t);
+		float cost = fabsf(shifts[k]) + 100.0f * fmaxf(0.0f, fabsf(lateral) - max_lateral); // rather not leave the track
+		if (cost < best_cost) {
+			best_cost = cost;
+			best_shift = shifts[k];
+		}
+	}
+	return target + best_shift * n;
+}
+
+u8 Autopilot::drive(Player *player, Track *track, Track *next, bool gameover) {
+	if (gameover) return player->input.buttons ? 0 : PB_ACCELERATE;
+	if (!player->alive || player->oil_spill > 0.0f || track->segments.empty()) return 0; // nothing to control
+
+	vec2 p = v2(player->position);
+	TrackSegment *s = cursor.find(track, p);
+	if (cursor.index + 1 == track->segments.size() && dot(s->dir, p - s->p) > s->dims.y && next && !next->segments.empty()) {
+		track = next; // already on the next chunk
+		next = nullptr;
+		s = cursor.find(track, p);
+	}
+
+	// aim further ahead the faster we go, plan a little further than that
+	float look_ahead = 8.0f + 0.6f * fmaxf(player->speed, 0.0f);
+	Track *target_track = track;
+	size_t target_index = cursor.index;
+	float target_d = dot(s->dir, p - s->p) + look_ahead;
+	TrackSegment *ts = walkSegments(&target_track, &target_index, &target_d, next);
+	Track *scan_track = target_track;
+	size_t scan_index = target_index;
+	float scan_d = target_d + AUTOPILOT_SCAN_DISTANCE;
+	walkSegments(&scan_track, &scan_index, &scan_d, next);
+
+	// the next gas tank up to there picks the lane (offset from the center line), it's kept on the track
+	// steering straight at one could cut a corner off the edge
+	float lane = 0.0f;
+	vec2 forward = dirFromAngle(player->heading);
+	if (seek_gas && player->fuel < 0.95f) {
+		forEachPickupAhead(track, cursor.index, scan_track, scan_index, next, p, forward, [&](Pickup &pickup, TrackSegment &ps) {
+			if (pickup.type != PT_GAS_TANK) return false;
+			lane = dot(v2(pickup.position) - ps.p, ps.t);
+			return true; // the nearest one
+		});
+	}
+	float max_lateral = 0.5f * ts->dims.x - AUTOPILOT_EDGE_MARGIN;
+	lane = fmaxf(-max_lateral, fminf(max_lateral, lane));
+	vec2 target = ts->p + target_d * ts->dir + lane * ts->t;
+
+	// then the way there is moved around oil spills
+	if (avoid_oil) {
+		forEachPickupAhead(track, cursor.index, target_track, target_index, next, p, forward, [&](Pickup &pickup, TrackSegment &ps) {
+			if (pickup.type == PT_OIL_SPILL) target = avoidOilSpill(p, target, v2(pickup.position), ts);
+			return false; // all of them
+		});
+	}
+
+	u8 buttons = 0;
+	float error = wrapMPi(angleFromDir(target - p) - player->heading);
+	if (error > AUTOPILOT_STEER_DEADBAND) buttons |= PB_STEER_LEFT;
+	if (error < -AUTOPILOT_STEER_DEADBAND) buttons |= PB_STEER_RIGHT;
+
+	// only slow down for sharp turns, fuel burns by the second
+	float target_speed = fmaxf(AUTOPILOT_MIN_SPEED, max_speed * (1.0f - 0.5f * fabsf(error)));
+	if (player->speed < target_speed) buttons |= PB_ACCELERATE;
+	else if (player->speed > target_speed + 4.0f) buttons |= PB_DECELERATE;
+	return buttons;
+}
@@ -0,0 +1,14 @@
+// drives the car instead of a human, for soak tests and benchmarks
+// looks at the segments and pickups a short distance ahead, so a tick only costs a handful of them
+struct Autopilot {
+	TrackCursor cursor; // its own, the player's is left to checkTrack
+
+	// driving style, different ones are compared by the batch runner
+	float max_speed = 36.0f; // m/s, steering gets weak when going faster
+	bool seek_gas = true; // changes lanes for gas tanks
+	bool avoid_oil = true;
+
+	// PlayerButton bits for the next tick, next continues track (endless mode)
+	// restarts the game by pressing and releasing a button when it's over
+	u8 drive(Player *player, Track *track, Track *next, bool gameover);
+};
@@ -0,0 +1,10 @@
+// the numbers the game is balanced with, every game has its own so they can be swept in parallel (see main_batch.cpp)
+struct GameBalance {
+	float difficulty_per_level = 0.1f; // level n's track has n times this, endless mode ramps up by as much per ENDLESS_LEVEL_LENGTH
+	float gas_tank_interval = 400.0f; // meters between gas tanks at difficulty 0
+	float gas_tank_interval_per_difficulty = 400.0f; // added at difficulty 1
+	float idle_fuel_consumption = 1.0f / 60.0f; // of a full tank per second
+	float acceleration_fuel_consumption = 1.0f / 60.0f; // on top of idling
+};
+
+const GameBalance default_balance = GameBalance(); // for players and tracks outside of a game
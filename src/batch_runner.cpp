@@ -0,0 +1,116 @@
+const char *driver_policy_names[DP_COUNT] = {"autopilot", "no-gas", "no-oil", "cautious"};
+
+static void setDriverPolicy(Autopilot *autopilot, DriverPolicy policy) {
+	switch (policy) {
+		case DP_NO_GAS: autopilot->seek_gas = false; break;
+		case DP_NO_OIL: autopilot->avoid_oil = false; break;
+		case DP_CAUTIOUS: autopilot->max_speed = 28.0f; break;
+		default: break;
+	}
+}
+
+BatchResult BatchRunner::runInstance(const BatchInstance &instance) {
+	PROFILE_SCOPE("BatchRunner::runInstance");
+	auto begin = std::chrono::steady_clock::now();
+	Game *game = new Game();
+	game->seed = instance.seed;
+	game->balance = balance;
+	game->balance.difficulty_per_level = instance.difficulty_per_level;
+	game->track_generator.threaded = false; // the other cores are busy with their own games
+	Autopilot autopilot;
+	setDriverPolicy(&autopilot, instance.policy);
+	game->autopilot = &autopilot;
+	game->init();
+
+	BatchResult result = {};
+	Player &player = game->player;
+	int level = game->level;
+	float track_length = game->currentTrack().length;
+	float last_fuel = player.fuel;
+	float completed_distance = 0.0f;
+	bool was_alive = true;
+	bool was_oiled = false;
+	while (result.ticks < max_ticks && !game->gameover) {
+		game->update(SIM_TIME_STEP);
+		result.ticks++;
+		if (game->level != level) { // the player was moved to the next track
+			completed_distance += track_length;
+			result.fuel_margin += last_fuel;
+			result.levels_finished++;
+			level = game->level;
+			track_length = game->currentTrack().length;
+		}
+		if (was_alive && !player.alive && player.fell_off_track) result.falls++;
+		if (!was_oiled && player.oil_spill > 0.0f) result.oil_spills++;
+		was_alive = player.alive;
+		was_oiled = player.oil_spill > 0.0f;
+		last_fuel = player.fuel;
+	}
+	result.distance = completed_distance + player.distance;
+	result.level = game->level;
+	result.timed_out = !game->gameover;
+
+	game->destroy();
+	delete game;
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+	result.time = elapsed.count();
+	return result;
+}
+
+bool BatchRunner::pop(Worker *worker, size_t *index) {
+	std::lock_guard<std::mutex> lock(worker->mutex);
+	if (worker->queue.empty()) return false;
+	*index = worker->queue.back();
+	worker->queue.pop_back();
+	return true;
+}
+
+bool BatchRunner::steal(Worker *victim, size_t *index) {
+	std::lock_guard<std::mutex> lock(victim->mutex);
+	if (victim->queue.empty()) return false;
+	*index = victim->queue.front();
+	victim->queue.pop_front();
+	return true;
+}
+
+void BatchRunner::work(int worker_index, const std::vector<BatchInstance> *instances, std::vector<BatchResult> *results) {
+	if (worker_index > 0) profiler.setThreadName("batch worker"); // 0 is the calling thread
+	int worker_count = (int)_workers.size();
+	size_t index;
+	for (;;) {
+		if (!pop(_workers[worker_index], &index)) {
+			// nothing left here, the others' work is never refilled so all empty means done
+			bool stolen = false;
+			for (int k = 1; k < worker_count && !stolen; k++) {
+				stolen = steal(_workers[(worker_index + k) % worker_count], &index);
+			}
+			if (!stolen) break;
+			_steal_count++;
+		}
+		(*results)[index] = runInstance((*instances)[index]);
+	}
+}
+
+void BatchRunner::run(const std::vector<BatchInstance> &instances, std::vector<BatchResult> *results, int thread_count) {
+	results->assign(instances.size(), BatchResult());
+	if (thread_count < 1) thread_count = 1;
+
+	// contiguous blocks, instances next to each other tend to take similarly long so stealing evens it out
+	_workers.clear();
+	for (int i = 0; i < thread_count; i++) _workers.push_back(new Worker());
+	for (size_t i = 0; i < instances.size(); i++) {
+		_workers[i * (size_t)thread_count / instances.size()]->queue.push_back(i);
+	}
+	_steal_count = 0;
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < thread_count; i++) {
+		threads.push_back(std::thread(&BatchRunner::work, this, i, &instances, results));
+	}
+	work(0, &instances, results); // the calling thread helps
+	for (std::thread &thread : threads) thread.join();
+
+	for (Worker *worker : _workers) delete worker;
+	_workers.clear();
+	steal_count = _steal_count;
+}
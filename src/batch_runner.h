@@ -0,0 +1,54 @@
+// runs lots of independent headless games with the autopilot for balance sweeps
+// every game has its own state (including its GameBalance) and generates its tracks on the worker running it
+
+enum DriverPolicy {
+	DP_AUTOPILOT, // the default autopilot
+	DP_NO_GAS, // ignores gas tanks
+	DP_NO_OIL, // drives through oil spills
+	DP_CAUTIOUS, // slower
+	DP_COUNT
+};
+extern const char *driver_policy_names[DP_COUNT];
+
+struct BatchInstance {
+	u32 seed;
+	float difficulty_per_level; // replaces the one in BatchRunner::balance
+	DriverPolicy policy;
+};
+
+struct BatchResult {
+	float distance; // meters over all levels
+	int level; // reached
+	int levels_finished;
+	float fuel_margin; // sum of the fuel left when finishing a level
+	int falls; // off the track
+	int oil_spills; // driven through
+	int ticks;
+	bool timed_out; // no game over within BatchRunner::max_ticks
+	double time; // seconds it took to simulate
+};
+
+// each worker owns a deque of instances, pops from its back and steals from the front of the others' when it runs dry
+class BatchRunner {
+public:
+	GameBalance balance;
+	int max_ticks = 20 * 60 * 60; // per game
+
+	int steal_count = 0; // of the last run
+
+	void run(const std::vector<BatchInstance> &instances, std::vector<BatchResult> *results, int thread_count);
+	BatchResult runInstance(const BatchInstance &instance);
+
+private:
+	struct Worker {
+		std::mutex mutex;
+		std::deque<size_t> queue; // indices into the instances
+	};
+
+	bool pop(Worker *worker, size_t *index);
+	bool steal(Worker *victim, size_t *index);
+	void work(int worker_index, const std::vector<BatchInstance> *instances, std::vector<BatchResult> *results);
+
+	std::vector<Worker*> _workers;
+	std::atomic<int> _steal_count{0};
+};
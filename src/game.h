@@ -1,25 +1,75 @@
+const float SIM_TIME_STEP = 1.0f / 60.0f; // fixed, independent of the frame rate
+
+const int TRACK_RING_SIZE = 4;
+
+// endless mode
+const float ENDLESS_CHUNK_LENGTH = 300.0f; // in meters
+const float ENDLESS_LEVEL_LENGTH = 2500.0f; // difficulty goes up every this many meters
+const float ENDLESS_REBASE_DISTANCE = 4096.0f; // move the world back to the origin when getting this far away
+
+enum GameMode {
+	GM_LEVELS, // tracks with a finish line
+	GM_ENDLESS // one continuous track streamed in chunks
+};
+
+struct HUD; // render side, see hud_render.h
+
 class Game {
 public:
 	VideoMode video;
 	Camera camera;
 
 	Player player; // the car
+	ParticleSystem particles; // effects, only for show
 
 	bool gameover;
 	bool quit;
 
-	Track tracks[2];
+	GameMode mode = GM_LEVELS; // set before init
+
+	// ring of previous, current, next and pending track, the pending one is generated in the background
+	// in endless mode these are the chunks around the player
+	Track tracks[TRACK_RING_SIZE];
 	int current_track_idx;
+	int chunk; // endless mode: number of chunks passed
+	TrackGenerator track_generator;
 
 	int level;
+	int run; // number of games started in this session
+
+	u32 seed; // all randomness of a session follows from this, set before init
+	GameBalance balance; // set before init
+	ReplayWriter *recording = nullptr; // records the input of every tick if set
+	ReplayReader *replay = nullptr; // replaces the player's controls if set, quits when over
+	Autopilot *autopilot = nullptr; // replaces the player's controls if set, keeps playing forever
+
+	HUD *hud = nullptr; // created by initRender, stays null when headless
+	float camera_laziness = 0.2f; // per 1/60 s
+	bool loading = false; // render assets are still being loaded, draw the loading screen instead
 
 	void init();
-	void reset();
 	void destroy();
+	void reset();
+	Track &previousTrack() { return tracks[(current_track_idx+TRACK_RING_SIZE-1) % TRACK_RING_SIZE]; }
+	Track &currentTrack() { return tracks[current_track_idx]; }
+	Track &nextTrack() { return tracks[(current_track_idx+1) % TRACK_RING_SIZE]; }
+	Track &pendingTrack() { return tracks[(current_track_idx+2) % TRACK_RING_SIZE]; }
+	void requestPendingTrack();
+	void advanceChunk(); // endless mode, the player reached the next chunk
+	void rebase(vec2 offset); // moves the whole world
+	u64 levelSeed(int l); // every level's track has its own seed derived from the session seed
+	float levelDifficulty(int l);
+	float chunkDifficulty(float distance); // endless mode, at this accumulated distance
 
-	void updateCamera(float delta_time);
+	void update(float delta_time); // advances the simulation, no gl calls in here
+	void getMemoryUsage(MemoryReport *report);
 
+	// render side (game_render.cpp), not available in headless builds
+	void initRender();
+	void destroyRender();
+	void drawLoadingScreen(); // also uploads the next few assets
+	void updateCamera(float delta_time, float alpha);
+	void draw(float alpha, float delta_time); // alpha: fraction of a time step since the last update
 	void drawHUD();
-
-	void tick(float delta_time);
-};
\ No newline at end of file
+	void getRenderMemoryUsage(MemoryReport *report);
+};
@@ -0,0 +1,203 @@
+struct sth_stash* font_stash = nullptr;
+const int FONT_STASH_SIZE = 512;
+int font_opensans = 0;
+
+// straight out of the archive's mapping if there is one, it has to stay as long as fontstash needs it
+static AssetData font_asset;
+
+static void loadFont() {
+	font_asset.load("data/fonts/OpenSans/OpenSans-Regular.ttf");
+}
+
+static void initFont() {
+	font_stash = sth_create(FONT_STASH_SIZE, FONT_STASH_SIZE);
+	if (!font_stash) {
+		LOGE("Could not create font stash.");
+		exit(1);
+	}
+	font_opensans = font_asset.data ? sth_add_font_from_memory(font_stash, (unsigned char*)font_asset.data) : -1; // only reads it
+	if (font_opensans == -1) {
+		LOGE("Could not load font: OpenSans/OpenSans-Regular.ttf");
+		exit(1);
+	}
+	// fontstash keeps the whole file, glyphs go into an alpha texture
+	trackAsset(MT_FONTS, font_asset.size, 0, FONT_STASH_SIZE * FONT_STASH_SIZE);
+}
+
+static AssetLoader asset_loader;
+const double ASSET_UPLOAD_BUDGET = 0.008; // seconds per frame
+
+void Game::initRender() {
+	// setup gl
+	glEnable(GL_CULL_FACE);
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+	// fonts, meshes and textures, the loading screen is shown until they are all there
+	asset_loader.add(loadFont, initFont);
+	asset_loader.add(nullptr, Player::initRender); // gamelib loads the car on the main thread
+	asset_loader.add(Pickup::loadMeshes, nullptr);
+	asset_loader.add(Pickup::loadTextures, Pickup::initRender);
+	asset_loader.add(Track::loadFinishLine, Track::initRender);
+	asset_loader.add(ParticleSystem::loadTexture, ParticleSystem::initRender);
+	asset_loader.add(nullptr, HUD::initRender);
+	asset_loader.start();
+	loading = true;
+	hud = new HUD();
+}
+
+// progress bar, cleared with the scissor so it doesn't need any shaders or buffers
+void Game::drawLoadingScreen() {
+	PROFILE_SCOPE("Game::drawLoadingScreen");
+	if (asset_loader.update(ASSET_UPLOAD_BUDGET)) {
+		loading = false;
+		// pickup meshes are there now, let the worker build track meshes along with the tracks
+		track_generator.prepare = Track::prepareMesh;
+	}
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLint bar_width = viewport[2] / 2;
+	GLint bar_height = viewport[3] / 64 + 1;
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(viewport[0] + viewport[2] / 4, viewport[1] + viewport[3] / 2, (GLsizei)(asset_loader.progress() * (float)bar_width), bar_height);
+	glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glDisable(GL_SCISSOR_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+}
+
+void Game::destroyRender() {
+	asset_loader.finish(); // everything below expects to be loaded
+	loading = false;
+	// free gl resources
+	for (int i = 0; i < (int)ARRAY_COUNT(tracks); i++) {
+		tracks[i].destroyMesh();
+	}
+	Player::destroyRender();
+	Pickup::destroyRender();
+	Track::destroyRender();
+	ParticleSystem::destroyRender();
+	render_queue.forgetUniforms();
+	hud->destroy();
+	delete hud;
+	hud = nullptr;
+	HUD::destroyRender();
+}
+
+const size_t TRACK_UPLOAD_BUDGET = 16 * 1024; // bytes per frame
+
+void Game::updateCamera(float delta_time, float alpha) {
+	// follow the interpolated player
+	vec3 player_position = mix(player.prev_position, player.position, alpha);
+	float player_heading = mixAngles(player.prev_heading, player.heading, alpha);
+
+	// same smoothing at any frame rate
+	float t = 1.0f - powf(1.0f - camera_laziness, 60.0f * delta_time);
+
+	vec3 camera_target_location = player_position + v3(-11.0f * dirFromAngle(player_heading), 8.0f);
+	float camera_target_y_angle = -player_heading + 0.5f * (float)M_PI;
+	if (player.speed < 0.0f) {
+		camera_target_y_angle -= (float)M_PI; // reversing
+		camera_target_location = player_position + v3(11.0f * dirFromAngle(player_heading), 8.0f);
+	}
+
+	if (!player.fell_off_track) { // don't follow the player off track
+		camera.location = mix(camera.location, camera_target_location, t);
+	}
+	//float delta = wrapMPi(camera_target_y_angle - camera.euler_angles.y);
+	//if (delta > 0.0f) delta = fminf(delta, 10.0f*delta_time);
+	//if (delta < 0.0f) delta = fmaxf(delta, -10.0f*delta_time);
+	//camera.euler_angles.y = wrapMPi(camera.euler_angles.y + delta);
+	camera.euler_angles.y = mixAngles(camera.euler_angles.y, camera_target_y_angle, t);
+
+	camera.field_of_view = 0.25f * (float)M_PI; // 45°
+	camera.aspect_ratio = (float)video.width / (float)video.height;
+	camera.setPerspectiveProjection(0.1f, 1000.0f);
+	camera.euler_angles.x = -0.39f * (float)M_PI; // 90°
+	camera.updateRotationMatrix();
+	camera.updateViewMatrix();
+	camera.updateViewProjectionMatrix();
+}
+
+
+void Game::draw(float alpha, float delta_time) {
+#ifdef DEBUG
+	ImGui::Begin("camera");
+	ImGui::SliderFloat("laziness", &camera_laziness, 0.0f, 1.0f);
+	ImGui::End();
+
+	ImGui::Begin("track");
+	static float track_difficulty = 0.5f;
+	ImGui::SliderFloat("difficulty", &track_difficulty, 0.0f, 1.0f);
+	if (mode == GM_LEVELS && ImGui::Button("generate")) {
+		Track &track = currentTrack();
+		track.generate(track_difficulty, hashSeed(levelSeed(level), (u64)track.revision));
+	}
+	ImGui::End();
+
+	ImGui::Begin("effects");
+	if (ImGui::Button("explode")) player.onExploded();
+	if (ImGui::Button("oilspill")) player.onOilSpill();
+	ImGui::Checkbox("center", &player.centerOnTrack);
+	ImGui::Checkbox("left", &player.leftOnTrack);
+	ImGui::Checkbox("right", &player.rightOnTrack);
+	ImGui::End();
+
+	ImGui::Begin("car");
+	ImGui::Text("speed: %f m/s", (double)player.speed);
+	ImGui::Text("speed: %f km/h", (double)player.speed * 3.6);
+	ImGui::End();
+#endif
+
+	PROFILE_SCOPE("Game::draw");
+	if (!gameover) updateCamera(delta_time, alpha);
+
+	// the 3d draws are recorded into render_queue and submitted sorted, the hud is drawn directly
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// upload the pending track a little every frame, way before it's needed
+	Track &pending = pendingTrack();
+	if (track_generator.isDone(&pending)) {
+		PROFILE_SCOPE("upload track");
+		pending.uploadMesh(TRACK_UPLOAD_BUDGET);
+	}
+
+	ProfileScope tracks_scope("draw tracks");
+	if (mode == GM_ENDLESS) previousTrack().draw(camera.view_proj_mat, delta_time); // still behind us
+	currentTrack().draw(camera.view_proj_mat, delta_time);
+	nextTrack().draw(camera.view_proj_mat, delta_time);
+	tracks_scope.end();
+	ProfileScope player_scope("draw player");
+	player.draw(camera.view_proj_mat, alpha);
+	player_scope.end();
+	ProfileScope particles_scope("draw particles");
+	particles.draw(&camera, alpha);
+	particles_scope.end();
+	render_queue.submit();
+
+	drawHUD();
+}
+
+// distance meter and fuel level
+void Game::drawHUD() {
+	PROFILE_SCOPE("drawHUD");
+	float goal_length = currentTrack().length;
+	float distance_left = goal_length - player.distance;
+	if (mode == GM_ENDLESS) { // the goal is the next level of difficulty
+		goal_length = ENDLESS_LEVEL_LENGTH;
+		distance_left = (float)level * ENDLESS_LEVEL_LENGTH - player.distance;
+	}
+	hud->draw(&video, distance_left, goal_length, player.fuel, level, gameover);
+}
+
+void Game::getRenderMemoryUsage(MemoryReport *report) {
+	for (int i = 0; i < TRACK_RING_SIZE; i++) {
+		// the worker might still be building this one's mesh
+		if (&tracks[i] == &pendingTrack() && !track_generator.isDone(&tracks[i])) continue;
+		tracks[i].getMeshMemoryUsage(report);
+	}
+	particles.getRenderMemoryUsage(report);
+	hud->getMemoryUsage(report);
+}
\ No newline at end of file
@@ -0,0 +1,364 @@
+GLNullStats gl_null_frame;
+GLNullStats gl_null_max;
+GLNullStats gl_null_total;
+int gl_null_frame_count = 0;
+
+static GLuint gl_null_next_name = 1; // shared by all object types
+static GLint gl_null_next_location = 0;
+static GLuint gl_null_program = 0;
+static GLuint gl_null_array_buffer = 0;
+static GLuint gl_null_element_buffer = 0;
+static GLuint gl_null_textures[32]; // per unit
+static GLenum gl_null_active_texture = 0; // unit index
+static GLint gl_null_viewport[4]; // x, y, width, height
+static GLint gl_null_scissor_box[4];
+
+// base level size of each texture, indexed by name, for glGetTexLevelParameteriv
+struct GLNullTextureSize {
+	GLint width, height;
+};
+static std::vector<GLNullTextureSize> gl_null_texture_sizes;
+
+template <typename T>
+static void glNullMax(T *a, T b) {
+	if (b > *a) *a = b;
+}
+
+void glNullEndFrame() {
+	GLNullStats &f = gl_null_frame;
+	GLNullStats &m = gl_null_max;
+	GLNullStats &t = gl_null_total;
+	glNullMax(&m.draw_calls, f.draw_calls);             t.draw_calls += f.draw_calls;
+	glNullMax(&m.vertices, f.vertices);                 t.vertices += f.vertices;
+	glNullMax(&m.program_binds, f.program_binds);       t.program_binds += f.program_binds;
+	glNullMax(&m.buffer_binds, f.buffer_binds);         t.buffer_binds += f.buffer_binds;
+	glNullMax(&m.texture_binds, f.texture_binds);       t.texture_binds += f.texture_binds;
+	glNullMax(&m.redundant_binds, f.redundant_binds);   t.redundant_binds += f.redundant_binds;
+	glNullMax(&m.uniform_uploads, f.uniform_uploads);   t.uniform_uploads += f.uniform_uploads;
+	glNullMax(&m.state_changes, f.state_changes);       t.state_changes += f.state_changes;
+	glNullMax(&m.buffer_bytes, f.buffer_bytes);         t.buffer_bytes += f.buffer_bytes;
+	glNullMax(&m.texture_bytes, f.texture_bytes);       t.texture_bytes += f.texture_bytes;
+	gl_null_frame = GLNullStats();
+	gl_null_frame_count++;
+}
+
+static void glNullGenNames(GLsizei n, GLuint *names) {
+	for (GLsizei i = 0; i < n; i++) names[i] = gl_null_next_name++;
+}
+
+// bytes per pixel of uncompressed uploads
+static size_t glNullPixelSize(GLenum format, GLenum type) {
+	if (type == GL_UNSIGNED_SHORT_5_6_5 || type == GL_UNSIGNED_SHORT_4_4_4_4 || type == GL_UNSIGNED_SHORT_5_5_5_1) return 2;
+	size_t components = 4;
+	switch (format) {
+		case GL_ALPHA: case GL_LUMINANCE: case GL_RED: components = 1; break;
+		case GL_LUMINANCE_ALPHA: case GL_RG: components = 2; break;
+		case GL_RGB: case GL_BGR: components = 3; break;
+	}
+	return components * (type == GL_FLOAT ? 4 : type == GL_UNSIGNED_SHORT || type == GL_SHORT ? 2 : 1);
+}
+
+// objects, the names only have to be unique
+void APIENTRY glGenBuffers(GLsizei n, GLuint *buffers) { glNullGenNames(n, buffers); }
+void APIENTRY glGenTextures(GLsizei n, GLuint *textures) { glNullGenNames(n, textures); }
+void APIENTRY glGenFramebuffers(GLsizei n, GLuint *framebuffers) { glNullGenNames(n, framebuffers); }
+void APIENTRY glGenRenderbuffers(GLsizei n, GLuint *renderbuffers) { glNullGenNames(n, renderbuffers); }
+GLuint APIENTRY glCreateProgram(void) { return gl_null_next_name++; }
+GLuint APIENTRY glCreateShader(GLenum type) { return gl_null_next_name++; }
+void APIENTRY glDeleteBuffers(GLsizei n, const GLuint *buffers) {
+	for (GLsizei i = 0; i < n; i++) {
+		if (buffers[i] == gl_null_array_buffer) gl_null_array_buffer = 0;
+		if (buffers[i] == gl_null_element_buffer) gl_null_element_buffer = 0;
+	}
+}
+void APIENTRY glDeleteTextures(GLsizei n, const GLuint *textures) {
+	for (GLsizei i = 0; i < n; i++) {
+		if (textures[i] < gl_null_texture_sizes.size()) gl_null_texture_sizes[textures[i]] = GLNullTextureSize();
+		for (int u = 0; u < (int)ARRAY_COUNT(gl_null_textures); u++) {
+			if (gl_null_textures[u] == textures[i]) gl_null_textures[u] = 0;
+		}
+	}
+}
+void APIENTRY glDeleteFramebuffers(GLsizei n, const GLuint *framebuffers) {}
+void APIENTRY glDeleteRenderbuffers(GLsizei n, const GLuint *renderbuffers) {}
+void APIENTRY glDeleteProgram(GLuint program) { if (program == gl_null_program) gl_null_program = 0; }
+void APIENTRY glDeleteShader(GLuint shader) {}
+GLboolean APIENTRY glIsBuffer(GLuint buffer) { return buffer != 0; }
+GLboolean APIENTRY glIsTexture(GLuint texture) { return texture != 0; }
+GLboolean APIENTRY glIsFramebuffer(GLuint framebuffer) { return framebuffer != 0; }
+GLboolean APIENTRY glIsRenderbuffer(GLuint renderbuffer) { return renderbuffer != 0; }
+GLboolean APIENTRY glIsProgram(GLuint program) { return program != 0; }
+GLboolean APIENTRY glIsShader(GLuint shader) { return shader != 0; }
+
+// binds
+void APIENTRY glUseProgram(GLuint program) {
+	gl_null_frame.program_binds++;
+	if (program == gl_null_program) gl_null_frame.redundant_binds++;
+	gl_null_program = program;
+}
+void APIENTRY glBindBuffer(GLenum target, GLuint buffer) {
+	GLuint *bound = target == GL_ELEMENT_ARRAY_BUFFER ? &gl_null_element_buffer : &gl_null_array_buffer;
+	gl_null_frame.buffer_binds++;
+	if (buffer == *bound) gl_null_frame.redundant_binds++;
+	*bound = buffer;
+}
+void APIENTRY glActiveTexture(GLenum texture) {
+	gl_null_frame.state_changes++;
+	gl_null_active_texture = (texture - GL_TEXTURE0) % ARRAY_COUNT(gl_null_textures);
+}
+void APIENTRY glBindTexture(GLenum target, GLuint texture) {
+	gl_null_frame.texture_binds++;
+	if (texture == gl_null_textures[gl_null_active_texture]) gl_null_frame.redundant_binds++;
+	gl_null_textures[gl_null_active_texture] = texture;
+}
+void APIENTRY glBindFramebuffer(GLenum target, GLuint framebuffer) { gl_null_frame.state_changes++; }
+void APIENTRY glBindRenderbuffer(GLenum target, GLuint renderbuffer) {}
+
+static void glNullSetTextureSize(GLint level, GLsizei width, GLsizei height) {
+	GLuint texture = gl_null_textures[gl_null_active_texture];
+	if (level != 0 || texture == 0) return;
+	if (texture >= gl_null_texture_sizes.size()) gl_null_texture_sizes.resize(texture + 1);
+	gl_null_texture_sizes[texture].width = width;
+	gl_null_texture_sizes[texture].height = height;
+}
+
+// uploads
+void APIENTRY glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {
+	if (data) gl_null_frame.buffer_bytes += (size_t)size;
+}
+void APIENTRY glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {
+	gl_null_frame.buffer_bytes += (size_t)size;
+}
+void APIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {
+	glNullSetTextureSize(level, width, height);
+	if (pixels) gl_null_frame.texture_bytes += (size_t)width * (size_t)height * glNullPixelSize(format, type);
+}
+void APIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {
+	gl_null_frame.texture_bytes += (size_t)width * (size_t)height * glNullPixelSize(format, type);
+}
+void APIENTRY glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void *data) {
+	glNullSetTextureSize(level, width, height);
+	gl_null_frame.texture_bytes += (size_t)imageSize;
+}
+void APIENTRY glCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void *data) {
+	gl_null_frame.texture_bytes += (size_t)imageSize;
+}
+void APIENTRY glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border) {}
+void APIENTRY glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height) {}
+void APIENTRY glGenerateMipmap(GLenum target) {}
+void APIENTRY glPixelStorei(GLenum pname, GLint param) {}
+void APIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param) {}
+void APIENTRY glTexParameterfv(GLenum target, GLenum pname, const GLfloat *params) {}
+void APIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+void APIENTRY glTexParameteriv(GLenum target, GLenum pname, const GLint *params) {}
+void APIENTRY glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {}
+void APIENTRY glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {}
+void APIENTRY glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {}
+GLenum APIENTRY glCheckFramebufferStatus(GLenum target) { return GL_FRAMEBUFFER_COMPLETE; }
+
+// draws
+void APIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count) {
+	gl_null_frame.draw_calls++;
+	gl_null_frame.vertices += (u32)count;
+}
+void APIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const void *indices) {
+	gl_null_frame.draw_calls++;
+	gl_null_frame.vertices += (u32)count;
+}
+void APIENTRY glClear(GLbitfield mask) {}
+void APIENTRY glFinish(void) {}
+void APIENTRY glFlush(void) {}
+void APIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void *pixels) {
+	memset(pixels, 0, (size_t)width * (size_t)height * glNullPixelSize(format, type));
+}
+
+// shaders always compile and link, uniforms get unique locations
+void APIENTRY glShaderSource(GLuint shader, GLsizei count, const GLchar *const*string, const GLint *length) {}
+void APIENTRY glCompileShader(GLuint shader) {}
+void APIENTRY glAttachShader(GLuint program, GLuint shader) {}
+void APIENTRY glDetachShader(GLuint program, GLuint shader) {}
+void APIENTRY glLinkProgram(GLuint program) {}
+void APIENTRY glValidateProgram(GLuint program) {}
+void APIENTRY glReleaseShaderCompiler(void) {}
+void APIENTRY glShaderBinary(GLsizei count, const GLuint *shaders, GLenum binaryFormat, const void *binary, GLsizei length) {}
+void APIENTRY glBindAttribLocation(GLuint program, GLuint index, const GLchar *name) {}
+GLint APIENTRY glGetAttribLocation(GLuint program, const GLchar *name) { return 0; }
+GLint APIENTRY glGetUniformLocation(GLuint program, const GLchar *name) { return gl_null_next_location++; }
+void APIENTRY glGetShaderiv(GLuint shader, GLenum pname, GLint *params) {
+	*params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+void APIENTRY glGetProgramiv(GLuint program, GLenum pname, GLint *params) {
+	*params = pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS ? GL_TRUE : 0;
+}
+void APIENTRY glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
+	if (length) *length = 0;
+	if (bufSize > 0) infoLog[0] = '\0';
+}
+void APIENTRY glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog) {
+	if (length) *length = 0;
+	if (bufSize > 0) infoLog[0] = '\0';
+}
+void APIENTRY glGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *source) {
+	if (length) *length = 0;
+	if (bufSize > 0) source[0] = '\0';
+}
+void APIENTRY glGetShaderPrecisionFormat(GLenum shadertype, GLenum precisiontype, GLint *range, GLint *precision) {
+	range[0] = range[1] = 127;
+	*precision = 23;
+}
+void APIENTRY glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name) {
+	if (length) *length = 0;
+	if (bufSize > 0) name[0] = '\0';
+}
+void APIENTRY glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name) {
+	if (length) *length = 0;
+	if (bufSize > 0) name[0] = '\0';
+}
+void APIENTRY glGetAttachedShaders(GLuint program, GLsizei maxCount, GLsizei *count, GLuint *shaders) {
+	if (count) *count = 0;
+}
+
+// uniforms
+void APIENTRY glUniform1f(GLint location, GLfloat v0) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform2f(GLint location, GLfloat v0, GLfloat v1) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform1i(GLint location, GLint v0) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform2i(GLint location, GLint v0, GLint v1) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform3i(GLint location, GLint v0, GLint v1, GLint v2) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform1fv(GLint location, GLsizei count, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform2fv(GLint location, GLsizei count, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform3fv(GLint location, GLsizei count, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform4fv(GLint location, GLsizei count, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform1iv(GLint location, GLsizei count, const GLint *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform2iv(GLint location, GLsizei count, const GLint *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform3iv(GLint location, GLsizei count, const GLint *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniform4iv(GLint location, GLsizei count, const GLint *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) { gl_null_frame.uniform_uploads++; }
+void APIENTRY glGetUniformfv(GLuint program, GLint location, GLfloat *params) { *params = 0.0f; }
+void APIENTRY glGetUniformiv(GLuint program, GLint location, GLint *params) { *params = 0; }
+
+// vertex attributes
+void APIENTRY glEnableVertexAttribArray(GLuint index) { gl_null_frame.state_changes++; }
+void APIENTRY glDisableVertexAttribArray(GLuint index) { gl_null_frame.state_changes++; }
+void APIENTRY glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) { gl_null_frame.state_changes++; }
+void APIENTRY glVertexAttrib1f(GLuint index, GLfloat x) {}
+void APIENTRY glVertexAttrib2f(GLuint index, GLfloat x, GLfloat y) {}
+void APIENTRY glVertexAttrib3f(GLuint index, GLfloat x, GLfloat y, GLfloat z) {}
+void APIENTRY glVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {}
+void APIENTRY glVertexAttrib1fv(GLuint index, const GLfloat *v) {}
+void APIENTRY glVertexAttrib2fv(GLuint index, const GLfloat *v) {}
+void APIENTRY glVertexAttrib3fv(GLuint index, const GLfloat *v) {}
+void APIENTRY glVertexAttrib4fv(GLuint index, const GLfloat *v) {}
+void APIENTRY glGetVertexAttribfv(GLuint index, GLenum pname, GLfloat *params) { *params = 0.0f; }
+void APIENTRY glGetVertexAttribiv(GLuint index, GLenum pname, GLint *params) { *params = 0; }
+void APIENTRY glGetVertexAttribPointerv(GLuint index, GLenum pname, void **pointer) { *pointer = nullptr; }
+
+// fixed state
+void APIENTRY glEnable(GLenum cap) { gl_null_frame.state_changes++; }
+void APIENTRY glDisable(GLenum cap) { gl_null_frame.state_changes++; }
+GLboolean APIENTRY glIsEnabled(GLenum cap) { return GL_FALSE; }
+void APIENTRY glBlendColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) { gl_null_frame.state_changes++; }
+void APIENTRY glBlendEquation(GLenum mode) { gl_null_frame.state_changes++; }
+void APIENTRY glBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) { gl_null_frame.state_changes++; }
+void APIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor) { gl_null_frame.state_changes++; }
+void APIENTRY glBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha) { gl_null_frame.state_changes++; }
+void APIENTRY glDepthFunc(GLenum func) { gl_null_frame.state_changes++; }
+void APIENTRY glDepthMask(GLboolean flag) { gl_null_frame.state_changes++; }
+void APIENTRY glDepthRangef(GLfloat n, GLfloat f) {}
+void APIENTRY glDepthRange(GLclampd n, GLclampd f) {}
+void APIENTRY glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {}
+void APIENTRY glClearDepthf(GLfloat d) {}
+void APIENTRY glClearDepth(GLclampd depth) {}
+void APIENTRY glClearStencil(GLint s) {}
+void APIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) { gl_null_frame.state_changes++; }
+void APIENTRY glCullFace(GLenum mode) { gl_null_frame.state_changes++; }
+void APIENTRY glFrontFace(GLenum mode) { gl_null_frame.state_changes++; }
+void APIENTRY glHint(GLenum target, GLenum mode) {}
+void APIENTRY glLineWidth(GLfloat width) {}
+void APIENTRY glPolygonOffset(GLfloat factor, GLfloat units) { gl_null_frame.state_changes++; }
+void APIENTRY glSampleCoverage(GLfloat value, GLboolean invert) {}
+void APIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+	GLint box[4] = {x, y, width, height};
+	memcpy(gl_null_scissor_box, box, sizeof(box));
+	gl_null_frame.state_changes++;
+}
+void APIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+	GLint rect[4] = {x, y, width, height};
+	memcpy(gl_null_viewport, rect, sizeof(rect));
+	gl_null_frame.state_changes++;
+}
+void APIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask) { gl_null_frame.state_changes++; }
+void APIENTRY glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask) { gl_null_frame.state_changes++; }
+void APIENTRY glStencilMask(GLuint mask) { gl_null_frame.state_changes++; }
+void APIENTRY glStencilMaskSeparate(GLenum face, GLuint mask) { gl_null_frame.state_changes++; }
+void APIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass) { gl_null_frame.state_changes++; }
+void APIENTRY glStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) { gl_null_frame.state_changes++; }
+
+// queries
+GLenum APIENTRY glGetError(void) { return GL_NO_ERROR; }
+const GLubyte *APIENTRY glGetString(GLenum name) {
+	switch (name) {
+		case GL_VENDOR: return (const GLubyte*)"null";
+		case GL_RENDERER: return (const GLubyte*)"null gl backend";
+		case GL_VERSION: return (const GLubyte*)"2.1 null";
+		case GL_SHADING_LANGUAGE_VERSION: return (const GLubyte*)"1.20";
+	}
+	return (const GLubyte*)"";
+}
+// number of values a glGet* query writes
+static int glNullValueCount(GLenum pname) {
+	switch (pname) {
+		case GL_VIEWPORT:
+		case GL_SCISSOR_BOX:
+		case GL_COLOR_WRITEMASK:
+		case GL_COLOR_CLEAR_VALUE:
+		case GL_BLEND_COLOR:
+			return 4;
+		case GL_MAX_VIEWPORT_DIMS:
+		case GL_DEPTH_RANGE:
+		case GL_ALIASED_POINT_SIZE_RANGE:
+		case GL_ALIASED_LINE_WIDTH_RANGE:
+			return 2;
+	}
+	return 1;
+}
+void APIENTRY glGetIntegerv(GLenum pname, GLint *data) {
+	for (int i = 0; i < glNullValueCount(pname); i++) data[i] = 0;
+	switch (pname) {
+		case GL_MAX_TEXTURE_SIZE: *data = 4096; break;
+		case GL_MAX_VERTEX_ATTRIBS: *data = 16; break;
+		case GL_MAX_TEXTURE_IMAGE_UNITS: *data = (GLint)ARRAY_COUNT(gl_null_textures); break;
+		case GL_MAX_VIEWPORT_DIMS: data[0] = data[1] = 4096; break;
+		case GL_CURRENT_PROGRAM: *data = (GLint)gl_null_program; break;
+		case GL_ARRAY_BUFFER_BINDING: *data = (GLint)gl_null_array_buffer; break;
+		case GL_ELEMENT_ARRAY_BUFFER_BINDING: *data = (GLint)gl_null_element_buffer; break;
+		case GL_TEXTURE_BINDING_2D: *data = (GLint)gl_null_textures[gl_null_active_texture]; break;
+		case GL_VIEWPORT: memcpy(data, gl_null_viewport, sizeof(gl_null_viewport)); break;
+		case GL_SCISSOR_BOX: memcpy(data, gl_null_scissor_box, sizeof(gl_null_scissor_box)); break;
+	}
+}
+void APIENTRY glGetBooleanv(GLenum pname, GLboolean *data) {
+	for (int i = 0; i < glNullValueCount(pname); i++) data[i] = GL_FALSE;
+}
+void APIENTRY glGetFloatv(GLenum pname, GLfloat *data) {
+	GLint values[4];
+	glGetIntegerv(pname, values);
+	for (int i = 0; i < glNullValueCount(pname); i++) data[i] = (GLfloat)values[i];
+}
+void APIENTRY glGetBufferParameteriv(GLenum target, GLenum pname, GLint *params) { *params = 0; }
+void APIENTRY glGetTexParameterfv(GLenum target, GLenum pname, GLfloat *params) { *params = 0.0f; }
+void APIENTRY glGetTexParameteriv(GLenum target, GLenum pname, GLint *params) { *params = 0; }
+void APIENTRY glGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint *params) {
+	*params = 0;
+	GLuint texture = gl_null_textures[gl_null_active_texture];
+	if (texture >= gl_null_texture_sizes.size() || level < 0 || level > 30) return;
+	GLNullTextureSize &size = gl_null_texture_sizes[texture];
+	GLint base = pname == GL_TEXTURE_WIDTH ? size.width : pname == GL_TEXTURE_HEIGHT ? size.height : 0;
+	if (base > 0) *params = base >> level > 0 ? base >> level : 1; // mip levels halve down to 1
+}
+void APIENTRY glGetFramebufferAttachmentParameteriv(GLenum target, GLenum attachment, GLenum pname, GLint *params) { *params = 0; }
+void APIENTRY glGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint *params) { *params = 0; }
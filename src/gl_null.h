@@ -0,0 +1,26 @@
+/*
+null gl backend: every gl entry point the renderer, gamelib and fontstash use
+(the gles 2.0 set plus a few desktop ones) without a driver
+nothing is drawn, but draw calls, binds, uniform uploads and bytes sent to
+the gpu are counted per frame, see main_nullgl.cpp
+*/
+
+struct GLNullStats {
+	u32 draw_calls = 0;
+	u32 vertices = 0; // drawn, indices for glDrawElements
+	u32 program_binds = 0;
+	u32 buffer_binds = 0;
+	u32 texture_binds = 0;
+	u32 redundant_binds = 0; // of the above, binding what was already bound
+	u32 uniform_uploads = 0;
+	u32 state_changes = 0; // enable, disable, blend, depth and attribute setup
+	size_t buffer_bytes = 0; // glBufferData and glBufferSubData
+	size_t texture_bytes = 0;
+};
+
+extern GLNullStats gl_null_frame; // since the last glNullEndFrame
+extern GLNullStats gl_null_max; // highest of every counter over all finished frames
+extern GLNullStats gl_null_total;
+extern int gl_null_frame_count;
+
+void glNullEndFrame();
@@ -0,0 +1,204 @@
+const int HUD_VA_POSITION = 0;
+const int HUD_VA_COLOR = 1;
+
+static const int hud_part_first_vertex[HP_COUNT+1] = {0, 24, 30, 39, 45, HUD_VERTEX_COUNT};
+
+static const u8 HUD_WHITE[4] = {255, 255, 255, 255};
+static const u8 HUD_FUEL_RED[4] = {255, 0, 0, 128};
+static const u8 HUD_SHADE[4] = {0, 0, 0, 128};
+
+static Shader hud_shader;
+static GLint hud_proj_loc;
+
+void HUD::initRender() {
+	const char *vert_source =
+	"uniform mat4 proj;"
+	"attribute vec2 position;"
+	"attribute vec4 color;"
+	"varying vec4 v_color;"
+	"void main() {"
+	"\tv_color = color;"
+	"\tgl_Position = proj * vec4(position, 0.0, 1.0);"
+	"}";
+
+	const char *frag_source =
+	"#ifdef GL_ES\n"
+	"precision mediump float;\n"
+	"#endif\n"
+	"varying vec4 v_color;"
+	"void main() {"
+	"\tgl_FragColor = v_color;"
+	"}";
+
+	hud_shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
+	hud_shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
+	hud_shader.bindVertexAttrib("position", HUD_VA_POSITION);
+	hud_shader.bindVertexAttrib("color", HUD_VA_COLOR);
+	hud_shader.link();
+	hud_shader.use();
+	hud_proj_loc = hud_shader.getUniformLocation("proj");
+}
+
+void HUD::destroyRender() {
+	hud_shader.destroy();
+}
+
+static HUDVertex *addVertex(HUDVertex *v, vec2 p, const u8 *color) {
+	v->position[0] = p.x;
+	v->position[1] = p.y;
+	memcpy(v->color, color, sizeof(v->color));
+	return v + 1;
+}
+
+// position, size
+static HUDVertex *addRect(HUDVertex *v, vec2 p, vec2 s, const u8 *color) {
+	v = addVertex(v, p, color);
+	v = addVertex(v, p + v2(s.x, 0.0f), color);
+	v = addVertex(v, p + s, color);
+	v = addVertex(v, p, color);
+	v = addVertex(v, p + s, color);
+	return addVertex(v, p + v2(0.0f, s.y), color);
+}
+
+HUDVertex *HUD::beginPart(HUDPart part) {
+	int first = hud_part_first_vertex[part];
+	int end = hud_part_first_vertex[part+1];
+	if (first < dirty_first) dirty_first = first;
+	if (end > dirty_end) dirty_end = end;
+	return &vertices[first];
+}
+
+void HUD::layout(VideoMode *video) {
+	layout_width = video->width;
+	layout_height = video->height;
+	float width = (float)video->width;
+	float height = (float)video->height;
+
+	proj_mat = makeOrtho(0.0f, width, 0.0f, height, -1.0f, 1.0f);
+	font_size = ceilf(0.1f * height);
+	padding = ceilf(0.025f * height);
+	thickness = 0.125f * padding;
+
+	// labels are right aligned
+	float minx, miny, maxx, maxy;
+	sth_dim_text(font_stash, font_opensans, font_size, "FUEL:", &minx, &miny, &maxx, &maxy);
+	float text_fuel_width = maxx - minx;
+	sth_dim_text(font_stash, font_opensans, font_size, "GOAL:", &minx, &miny, &maxx, &maxy);
+	float text_goal_width = maxx - minx;
+	sth_dim_text(font_stash, font_opensans, font_size, "LEVEL:", &minx, &miny, &maxx, &maxy);
+	float text_level_width = maxx - minx;
+	float max_text_width = fmaxf(fmaxf(text_fuel_width, text_goal_width), text_level_width);
+	goal_label_p = v3(padding + max_text_width - text_goal_width, height - font_size, 0.0f);
+	fuel_label_p = v3(padding + max_text_width - text_fuel_width, height - 2.0f*font_size, 0.0f);
+	level_text_p = v3(padding + max_text_width - text_level_width, height - 3.0f*font_size, 0.0f);
+	distance_text_p = v3(2.0f*padding + max_text_width, height - 1.25f*font_size, 0.0f);
+
+	sth_dim_text(font_stash, font_opensans, 2.0f*font_size, "GAME OVER", &minx, &miny, &maxx, &maxy);
+	game_over_p = v3(0.5f * (width - (maxx - minx)), 0.5f * (height - (maxy - miny)), 0.0f);
+
+	fuel_meter_p = v2(2.0f * padding + max_text_width, height - 2.0f*font_size);
+	fuel_meter_s = v2(width - 3.0f*padding - max_text_width, 0.55f*font_size);
+	goal_line_p = fuel_meter_p + v2(0.0f, font_size);
+	goal_line_s = v2(fuel_meter_s.x, 2.0f * thickness);
+
+	// fuel meter border
+	HUDVertex *v = beginPart(HP_FUEL_BORDER);
+	vec2 p = fuel_meter_p;
+	vec2 s = fuel_meter_s;
+	float t = thickness;
+	v = addRect(v, p, v2(s.x - t, t), HUD_WHITE);
+	v = addRect(v, p + v2(s.x - t, 0.0f), v2(t, s.y - t), HUD_WHITE);
+	v = addRect(v, p + v2(t, s.y - t), v2(s.x - t, t), HUD_WHITE);
+	addRect(v, p + v2(0.0, t), v2(t, s.y - t), HUD_WHITE);
+
+	addRect(beginPart(HP_GOAL_LINE), goal_line_p, goal_line_s, HUD_WHITE);
+	addRect(beginPart(HP_GAME_OVER), v2(0.0f), v2(width, height), HUD_SHADE);
+	shown_goal_x = -1; // the meters move with the layout
+	shown_fuel_width = -1;
+}
+
+void HUD::draw(VideoMode *video, float distance_left, float goal_length, float fuel, int level, bool gameover) {
+	if (video->width != layout_width || video->height != layout_height) layout(video);
+
+	if ((int)distance_left != shown_distance || shown_level < 0) { // or the first draw
+		shown_distance = (int)distance_left;
+		snprintf(distance_text, sizeof(distance_text), "in %dm", shown_distance);
+	}
+	if (level != shown_level) {
+		shown_level = level;
+		snprintf(level_text, sizeof(level_text), "LEVEL: %d", level);
+	}
+
+	float pixel_scale = video->pixel_scale;
+	float goal_fraction = fminf(1.0f, fmaxf(0.0f, distance_left / goal_length));
+	int goal_x = (int)(pixel_scale * (goal_line_s.x - thickness) * goal_fraction + 0.5f);
+	if (goal_x != shown_goal_x) {
+		shown_goal_x = goal_x;
+		float x = goal_line_p.x + (float)goal_x / pixel_scale;
+		HUDVertex *v = addRect(beginPart(HP_GOAL_MARKER), v2(x, goal_line_p.y), v2(thickness, fuel_meter_s.y), HUD_WHITE);
+		// little flag
+		x += thickness;
+		float y0 = goal_line_p.y + 0.666f * fuel_meter_s.y;
+		float y1 = goal_line_p.y + fuel_meter_s.y;
+		v = addVertex(v, v2(x, y0), HUD_WHITE);
+		v = addVertex(v, v2(x + 0.25f * fuel_meter_s.y, 0.5f * (y0+y1)), HUD_WHITE);
+		addVertex(v, v2(x, y1), HUD_WHITE);
+	}
+	vec2 fuel_fill = fuel_meter_s - v2(4.0f * thickness);
+	int fuel_width = (int)(pixel_scale * fuel_fill.x * fminf(1.0f, fmaxf(0.0f, fuel)) + 0.5f);
+	if (fuel_width != shown_fuel_width) {
+		shown_fuel_width = fuel_width;
+		fuel_fill.x = (float)fuel_width / pixel_scale;
+		addRect(beginPart(HP_FUEL_FILL), fuel_meter_p + v2(2.0f * thickness), fuel_fill, HUD_FUEL_RED);
+	}
+
+	// all text in one batch, below the quads like the game over shade always had it
+	vec4 font_color = v4(1.0f);
+	sth_begin_draw(font_stash, proj_mat.e);
+	sth_draw_text(font_stash, font_opensans, font_size, video->pixel_scale, goal_label_p.e, font_color.e, "GOAL:", nullptr);
+	sth_draw_text(font_stash, font_opensans, font_size, video->pixel_scale, fuel_label_p.e, font_color.e, "FUEL:", nullptr);
+	sth_draw_text(font_stash, font_opensans, 0.3f*font_size, video->pixel_scale, distance_text_p.e, font_color.e, distance_text, nullptr);
+	sth_draw_text(font_stash, font_opensans, font_size, video->pixel_scale, level_text_p.e, font_color.e, level_text, nullptr);
+	if (gameover) {
+		sth_draw_text(font_stash, font_opensans, 2.0f*font_size, video->pixel_scale, game_over_p.e, font_color.e, "GAME OVER", nullptr);
+	}
+	sth_end_draw(font_stash);
+
+	// only the parts that changed
+	if (!vbo) {
+		glGenBuffers(1, &vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_DYNAMIC_DRAW);
+	} else {
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		if (dirty_first < dirty_end) {
+			glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(sizeof(HUDVertex) * (size_t)dirty_first),
+				(GLsizeiptr)(sizeof(HUDVertex) * (size_t)(dirty_end - dirty_first)), &vertices[dirty_first]);
+		}
+	}
+	dirty_first = HUD_VERTEX_COUNT;
+	dirty_end = 0;
+
+	glDisable(GL_DEPTH_TEST);
+	hud_shader.use();
+	glUniformMatrix4fv(hud_proj_loc, 1, GL_FALSE, proj_mat.e);
+	glEnableVertexAttribArray((GLuint)HUD_VA_POSITION);
+	glVertexAttribPointer((GLuint)HUD_VA_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(HUDVertex), (GLvoid*)offsetof(HUDVertex, position));
+	glEnableVertexAttribArray((GLuint)HUD_VA_COLOR);
+	glVertexAttribPointer((GLuint)HUD_VA_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HUDVertex), (GLvoid*)offsetof(HUDVertex, color));
+	glDrawArrays(GL_TRIANGLES, 0, gameover ? HUD_VERTEX_COUNT : hud_part_first_vertex[HP_GAME_OVER]);
+	glDisableVertexAttribArray((GLuint)HUD_VA_POSITION);
+	glDisableVertexAttribArray((GLuint)HUD_VA_COLOR);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glEnable(GL_DEPTH_TEST);
+}
+
+void HUD::destroy() {
+	if (vbo) glDeleteBuffers(1, &vbo);
+	vbo = 0;
+	layout_width = layout_height = 0; // lay out and upload everything again
+}
+
+void HUD::getMemoryUsage(MemoryReport *report) {
+	report->add(MT_HUD, sizeof(HUD), vbo ? sizeof(vertices) : 0);
+}
@@ -0,0 +1,53 @@
+// screen space vertex of the hud's quads
+struct HUDVertex {
+	float position[2]; // in points
+	u8 color[4]; // normalized
+};
+
+// regions of HUD::vertices, in drawing order
+enum HUDPart {
+	HP_FUEL_BORDER, // 4 quads
+	HP_GOAL_LINE,
+	HP_GOAL_MARKER, // quad and flag triangle
+	HP_FUEL_FILL,
+	HP_GAME_OVER, // darkens the screen, only drawn at game over
+	HP_COUNT
+};
+
+const int HUD_VERTEX_COUNT = 4*6 + 6 + (6+3) + 6 + 6;
+
+// distance meter, fuel level and level number, attached to Game::hud by the renderer
+// the layout is computed once per resolution, text is formatted only when the shown numbers change
+// all quads are in one buffer which is updated in place, part by part
+struct HUD {
+	// layout, depends on the resolution only
+	int layout_width = 0, layout_height = 0;
+	mat4 proj_mat;
+	float font_size, padding, thickness;
+	vec3 goal_label_p, fuel_label_p, level_text_p, distance_text_p, game_over_p;
+	vec2 fuel_meter_p, fuel_meter_s;
+	vec2 goal_line_p, goal_line_s;
+
+	// what's currently shown
+	int shown_distance = -1;
+	int shown_level = -1;
+	char distance_text[32];
+	char level_text[32];
+	int shown_goal_x = -1; // marker and fuel fill in whole pixels, moving them by less doesn't show
+	int shown_fuel_width = -1;
+
+	HUDVertex vertices[HUD_VERTEX_COUNT];
+	GLuint vbo = 0;
+	int dirty_first = HUD_VERTEX_COUNT, dirty_end = 0; // vertex range to upload before drawing
+
+	static void initRender();
+	static void destroyRender();
+
+	void draw(VideoMode *video, float distance_left, float goal_length, float fuel, int level, bool gameover);
+	void destroy();
+	void getMemoryUsage(MemoryReport *report);
+
+private:
+	void layout(VideoMode *video);
+	HUDVertex *beginPart(HUDPart part); // marks the part's vertices for upload
+};
@@ -0,0 +1,231 @@
+/*
+runs many headless games with the autopilot on all cores and sums them up per difficulty and driver policy
+build with ./build.sh batch
+*/
+
+#include <assert.h>
+#include <time.h> // used by log
+#include <math.h> // for fabsf
+#include <float.h> // for FLT_MAX
+#ifdef __SSE2__
+	#include <emmintrin.h> // batched track queries
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm> // for sort
+
+// gamelib
+#include <system/defines.h>
+#include <system/log.h>
+#include <math/random.h>
+#include <math/vector_math.h>
+#include <math/trigonometry.h>
+#include <math/transform.h>
+#include <input/input.h>
+#include <video/video_mode.h>
+#include <video/camera.h>
+
+#include <math/transform.cpp>
+#include <system/log.cpp>
+
+#include "random_stream.h"
+#include "profiler.h"
+#include "memory_stats.h"
+#include "balance.h"
+#include "particles.h"
+#include "track_cursor.h"
+#include "player.h"
+#include "pickup.h"
+#include "track_collision.h"
+#include "track.h"
+#include "track_generator.h"
+#include "autopilot.h"
+#include "replay.h"
+#include "game.h"
+#include "batch_runner.h"
+
+#include "profiler.cpp"
+#include "memory_stats.cpp"
+#include "particles.cpp"
+#include "player.cpp"
+#include "pickup.cpp"
+#include "track.cpp"
+#include "track_collision.cpp"
+#include "track_cursor.cpp"
+#include "track_generator.cpp"
+#include "autopilot.cpp"
+#include "replay.cpp"
+#include "game.cpp"
+#include "batch_runner.cpp"
+
+static double getTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+}
+
+// comma separated numbers
+static bool parseFloats(const char *s, std::vector<float> *values) {
+	values->clear();
+	while (*s) {
+		char *end;
+		values->push_back(strtof(s, &end));
+		if (end == s) return false;
+		s = *end == ',' ? end + 1 : end;
+	}
+	return !values->empty();
+}
+
+// comma separated policy names
+static bool parsePolicies(const char *s, std::vector<DriverPolicy> *policies) {
+	policies->clear();
+	while (*s) {
+		size_t n = strcspn(s, ",");
+		int p = 0;
+		while (p < DP_COUNT && (strlen(driver_policy_names[p]) != n || strncmp(s, driver_policy_names[p], n) != 0)) p++;
+		if (p == DP_COUNT) return false;
+		policies->push_back((DriverPolicy)p);
+		s += n;
+		if (*s == ',') s++;
+	}
+	return !policies->empty();
+}
+
+static float percentile(std::vector<float> &sorted, float q) {
+	return sorted[(size_t)(q * (float)(sorted.size() - 1) + 0.5f)];
+}
+
+int main(int argc, char *argv[]) {
+	profiler.init();
+	profiler.setThreadName("main");
+	int seed_count = 64;
+	u32 first_seed = 1;
+	std::vector<float> difficulties(1, default_balance.difficulty_per_level);
+	std::vector<DriverPolicy> policies;
+	for (int p = 0; p < DP_COUNT; p++) policies.push_back((DriverPolicy)p);
+	int thread_count = (int)std::thread::hardware_concurrency();
+	const char *csv_filename = nullptr;
+	const char *profile_filename = nullptr;
+	BatchRunner runner;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--seeds") == 0 && i+1 < argc) {
+			seed_count = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--first-seed") == 0 && i+1 < argc) {
+			first_seed = (u32)strtoul(argv[++i], nullptr, 10);
+		} else if (strcmp(argv[i], "--difficulties") == 0 && i+1 < argc) {
+			if (!parseFloats(argv[++i], &difficulties)) {
+				LOGE("not a list of numbers: %s", argv[i]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--policies") == 0 && i+1 < argc) {
+			if (!parsePolicies(argv[++i], &policies)) {
+				LOGE("unknown policy in %s", argv[i]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--threads") == 0 && i+1 < argc) {
+			thread_count = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--minutes") == 0 && i+1 < argc) {
+			runner.max_ticks = (int)(60.0f * (float)atof(argv[++i]) / SIM_TIME_STEP);
+		} else if (strcmp(argv[i], "--gas-tank-interval") == 0 && i+1 < argc) {
+			runner.balance.gas_tank_interval = (float)atof(argv[++i]);
+		} else if (strcmp(argv[i], "--gas-tank-interval-per-difficulty") == 0 && i+1 < argc) {
+			runner.balance.gas_tank_interval_per_difficulty = (float)atof(argv[++i]);
+		} else if (strcmp(argv[i], "--idle-fuel") == 0 && i+1 < argc) {
+			runner.balance.idle_fuel_consumption = (float)atof(argv[++i]);
+		} else if (strcmp(argv[i], "--acceleration-fuel") == 0 && i+1 < argc) {
+			runner.balance.acceleration_fuel_consumption = (float)atof(argv[++i]);
+		} else if (strcmp(argv[i], "--csv") == 0 && i+1 < argc) {
+			csv_filename = argv[++i];
+		} else if (strcmp(argv[i], "--profile") == 0 && i+1 < argc) {
+			profile_filename = argv[++i];
+		} else {
+			LOGE("usage: %s [--seeds n] [--first-seed n] [--difficulties a,b,..] [--policies %s,..] [--threads n] [--minutes n]"
+				" [--gas-tank-interval m] [--gas-tank-interval-per-difficulty m] [--idle-fuel f] [--acceleration-fuel f]"
+				" [--csv file] [--profile trace.json]", argv[0], driver_policy_names[0]);
+			return 1;
+		}
+	}
+	if (thread_count < 1) thread_count = 1;
+	if (profile_filename) profiler.enabled = true;
+
+	// every seed with every difficulty and policy, grouped by the latter two
+	std::vector<BatchInstance> instances;
+	for (float difficulty : difficulties) {
+		for (DriverPolicy policy : policies) {
+			for (int s = 0; s < seed_count; s++) {
+				BatchInstance instance = {first_seed + (u32)s, difficulty, policy};
+				instances.push_back(instance);
+			}
+		}
+	}
+
+	LOGI("%d games on %d threads, up to %.1f minutes each", (int)instances.size(), thread_count,
+		(double)((float)runner.max_ticks * SIM_TIME_STEP / 60.0f));
+	std::vector<BatchResult> results;
+	double begin_time = getTime();
+	runner.run(instances, &results, thread_count);
+	double elapsed_time = getTime() - begin_time;
+
+	double busy_time = 0.0;
+	long long ticks = 0;
+	for (BatchResult &r : results) {
+		busy_time += r.time;
+		ticks += r.ticks;
+	}
+	LOGI("%.3f s, %.0f games/s, %.0f ticks/s, %d steals, %.0f%% of the threads busy", elapsed_time,
+		(double)results.size() / elapsed_time, (double)ticks / elapsed_time, runner.steal_count,
+		100.0 * busy_time / (elapsed_time * (double)thread_count));
+
+	LOGI("difficulty policy      games  distance p10/p50/p90 (m)  level avg/max  fuel margin  falls  oil  timeouts");
+	size_t group_size = (size_t)seed_count;
+	for (size_t first = 0; first + group_size <= results.size() && group_size > 0; first += group_size) {
+		std::vector<float> distances;
+		double level_sum = 0.0, fuel_margin_sum = 0.0;
+		int max_level = 0, levels_finished = 0, falls = 0, oil_spills = 0, timeouts = 0;
+		for (size_t i = first; i < first + group_size; i++) {
+			BatchResult &r = results[i];
+			distances.push_back(r.distance);
+			level_sum += r.level;
+			if (r.level > max_level) max_level = r.level;
+			fuel_margin_sum += (double)r.fuel_margin;
+			levels_finished += r.levels_finished;
+			falls += r.falls;
+			oil_spills += r.oil_spills;
+			if (r.timed_out) timeouts++;
+		}
+		std::sort(distances.begin(), distances.end());
+		double n = (double)group_size;
+		LOGI("%10.3f %-10s %6d %8.0f %8.0f %8.0f %8.2f %4d %12.3f %6.2f %4.2f %9d",
+			(double)instances[first].difficulty_per_level, driver_policy_names[instances[first].policy], (int)group_size,
+			(double)percentile(distances, 0.1f), (double)percentile(distances, 0.5f), (double)percentile(distances, 0.9f),
+			level_sum / n, max_level, levels_finished > 0 ? fuel_margin_sum / (double)levels_finished : 0.0,
+			(double)falls / n, (double)oil_spills / n, timeouts);
+	}
+
+	if (csv_filename) {
+		FILE *file = fopen(csv_filename, "w");
+		if (!file) {
+			LOGE("Could not write %s", csv_filename);
+			return 1;
+		}
+		fprintf(file, "seed,difficulty_per_level,policy,distance,level,levels_finished,fuel_margin,falls,oil_spills,ticks,timed_out\n");
+		for (size_t i = 0; i < results.size(); i++) {
+			BatchInstance &b = instances[i];
+			BatchResult &r = results[i];
+			fprintf(file, "%u,%g,%s,%.1f,%d,%d,%.3f,%d,%d,%d,%d\n", b.seed, (double)b.difficulty_per_level,
+				driver_policy_names[b.policy], (double)r.distance, r.level, r.levels_finished, (double)r.fuel_margin,
+				r.falls, r.oil_spills, r.ticks, r.timed_out ? 1 : 0);
+		}
+		fclose(file);
+	}
+	if (profile_filename) profiler.writeTrace(profile_filename);
+	return 0;
+}
@@ -0,0 +1,370 @@
+/*
+microbenchmarks of the simulation's hot paths and the cpu side of the track mesh
+no window and no gpu needed, the render code links against the null gl backend (gl_null.cpp)
+prints one JSON object with the statistics of every benchmark
+build with ./build.sh bench, run from build/ so the pickup models are found
+*/
+
+#include <assert.h>
+#include <time.h> // used by log
+#include <math.h> // for fabsf
+#include <float.h> // for FLT_MAX
+#include <stddef.h> // for offsetof
+#ifdef __SSE2__
+	#include <emmintrin.h> // batched track queries
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h> // asset archive
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm> // for sort
+
+// only the prototypes, gl_null.cpp defines them
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// gamelib
+#include <system/defines.h>
+#include <system/files.h>
+#include <system/log.h>
+#include <math/random.h>
+#include <math/vector_math.h>
+#include <math/trigonometry.h>
+#include <math/transform.h>
+#include <input/input.h>
+#include <video/video_mode.h>
+#include <video/camera.h>
+#include <video/shader.h>
+#include <video/image.h>
+#include <video/texture.h>
+#include <video/model_mdl.h>
+
+#include <math/transform.cpp>
+#include <system/files.cpp>
+#include <system/log.cpp>
+#include <video/shader.cpp>
+#include <video/image.cpp>
+#include <video/texture.cpp>
+#include <video/texture_null.cpp>
+#include <video/model_mdl.cpp>
+
+#include "gl_null.h"
+#include "random_stream.h"
+#include "profiler.h"
+#include "memory_stats.h"
+#include "asset_archive.h"
+#include "balance.h"
+#include "particles.h"
+#include "track_cursor.h"
+#include "player.h"
+#include "pickup.h"
+#include "track_collision.h"
+#include "track.h"
+#include "track_generator.h"
+#include "autopilot.h"
+#include "static_mesh.h"
+#include "texture_image.h"
+#include "render_queue.h"
+#include "pickup_render.h"
+#include "track_render.h"
+#include "replay.h"
+#include "game.h" // only for SIM_TIME_STEP
+
+#include "gl_null.cpp"
+#include "profiler.cpp"
+#include "memory_stats.cpp"
+#include "asset_archive.cpp"
+#include "particles.cpp"
+#include "player.cpp"
+#include "pickup.cpp"
+#include "track.cpp"
+#include "track_collision.cpp"
+#include "track_cursor.cpp"
+
+#include "render_queue.cpp"
+#include "static_mesh.cpp"
+#include "texture_image.cpp"
+#include "memory_stats_render.cpp"
+#include "pickup_render.cpp"
+#include "track_render.cpp"
+
+static double getTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+}
+
+const int BENCH_MIN_SAMPLES = 10;
+const int BENCH_MAX_SAMPLES = 1000;
+const double BENCH_MIN_SAMPLE_TIME = 0.001; // seconds, iterations per sample are doubled until one takes this long
+
+static FILE *bench_out;
+static const char *bench_filter = nullptr; // only benchmarks whose name contains this
+static double bench_min_time = 0.25; // seconds of samples per benchmark
+static int bench_count = 0;
+static volatile u64 bench_sink; // results go here so the work isn't optimized away
+
+// times op(iterations), which returns something that depends on its work
+// params is the inside of a JSON object, e.g. "\"difficulty\": 0.5"
+template <typename F>
+static void runBench(const char *name, const char *params, F op) {
+	if (bench_filter && !strstr(name, bench_filter)) return;
+
+	bench_sink += op(1); // warm up
+	int iterations = 1;
+	for (;;) {
+		double begin_time = getTime();
+		bench_sink += op(iterations);
+		if (getTime() - begin_time >= BENCH_MIN_SAMPLE_TIME || iterations >= (1 << 24)) break;
+		iterations *= 2;
+	}
+
+	std::vector<double> samples; // ns per op
+	double total_time = 0.0;
+	while (samples.size() < (size_t)BENCH_MAX_SAMPLES && (samples.size() < (size_t)BENCH_MIN_SAMPLES || total_time < bench_min_time)) {
+		double begin_time = getTime();
+		bench_sink += op(iterations);
+		double time = getTime() - begin_time;
+		total_time += time;
+		samples.push_back(1.0e9 * time / (double)iterations);
+	}
+
+	std::sort(samples.begin(), samples.end());
+	double mean = 0.0;
+	for (double s : samples) mean += s;
+	mean /= (double)samples.size();
+	double variance = 0.0;
+	for (double s : samples) variance += (s - mean) * (s - mean);
+	variance /= (double)(samples.size() - 1);
+	size_t n = samples.size();
+	fprintf(bench_out, "%s\n\t\t{\"name\": \"%s\", \"params\": {%s}, \"unit\": \"ns/op\", \"iterations\": %d, \"samples\": %d, "
+		"\"min\": %.2f, \"p10\": %.2f, \"median\": %.2f, \"p90\": %.2f, \"max\": %.2f, \"mean\": %.2f, \"stddev\": %.2f}",
+		bench_count > 0 ? "," : "", name, params, iterations, (int)n, samples[0], samples[n / 10], samples[n / 2],
+		samples[n * 9 / 10], samples[n - 1], mean, sqrt(variance));
+	bench_count++;
+}
+
+// seeds cycle so no single track layout decides the result
+static void benchTrackGenerate() {
+	char params[128];
+	float difficulties[] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+	for (float difficulty : difficulties) {
+		Track track;
+		snprintf(params, sizeof(params), "\"difficulty\": %.2f, \"meters\": %.0f", (double)difficulty,
+			(double)getLevelLength(difficulty));
+		runBench("track_generate", params, [&](int n) {
+			u64 r = 0;
+			for (int i = 0; i < n; i++) {
+				track.generate(difficulty, (u64)(1 + (i & 15)));
+				r += track.segments.size();
+			}
+			return r;
+		});
+	}
+
+	float chunk_lengths[] = {250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f};
+	for (float chunk_length : chunk_lengths) {
+		Track track;
+		snprintf(params, sizeof(params), "\"difficulty\": 0.50, \"meters\": %.0f", (double)chunk_length);
+		runBench("track_generate_chunk", params, [&](int n) {
+			u64 r = 0;
+			for (int i = 0; i < n; i++) {
+				track.generateChunk(0.5f, (u64)(1 + (i & 15)), nullptr, chunk_length);
+				r += track.segments.size();
+			}
+			return r;
+		});
+	}
+}
+
+// points on the track's top, or next to it where every query misses
+static void makeProbes(Track *track, bool on_track, int count, std::vector<vec2> *points) {
+	RandomStream random(on_track ? 2 : 3);
+	points->resize((size_t)count);
+	for (int i = 0; i < count; i++) {
+		TrackSegment &s = track->segments[(size_t)(random.nextf() * (float)track->segments.size())];
+		float x = on_track ? random.rangef(-0.4f, 0.4f) * s.dims.x : (random.nextf() < 0.5f ? -1.0f : 1.0f) * (0.5f * s.dims.x + random.rangef(4.0f, 40.0f));
+		(*points)[(size_t)i] = s.p + x * s.t + random.nextf() * s.dims.y * s.dir;
+	}
+}
+
+static void benchTrackQueries() {
+	const int PROBE_COUNT = 4096;
+	Track track;
+	track.generate(0.5f, 1);
+	std::vector<vec2> points;
+	for (int k = 0; k < 2; k++) {
+		bool hit = k == 0;
+		makeProbes(&track, hit, PROBE_COUNT, &points);
+		const char *params = hit ? "\"probes\": \"hit\"" : "\"probes\": \"miss\"";
+		runBench("track_find_nearest_segment", params, [&](int n) {
+			u64 r = 0;
+			for (int i = 0; i < n; i++) {
+				r += (u64)(track.findNearestSegment(points[(size_t)(i & (PROBE_COUNT-1))]) - &track.segments[0]);
+			}
+			return r;
+		});
+		runBench("track_trace_z", params, [&](int n) {
+			u64 r = 0;
+			float z;
+			for (int i = 0; i < n; i++) {
+				r += track.traceZ(points[(size_t)(i & (PROBE_COUNT-1))], &z) ? 1 : 0;
+			}
+			return r;
+		});
+	}
+}
+
+static void benchPlayer() {
+	// steers left and right while accelerating, never leaves the (virtual) ground without checkTrack
+	Player player;
+	player.init();
+	player.respawn(v3(0.0f, 0.0f, 50.0f), v2(0.0f, 1.0f));
+	runBench("player_tick", "", [&](int n) {
+		u64 r = 0;
+		for (int i = 0; i < n; i++) {
+			u8 steer = (i & 64) ? PB_STEER_LEFT : PB_STEER_RIGHT;
+			player.input.update((u8)(PB_ACCELERATE | steer));
+			player.fuel = 1.0f;
+			player.tick(SIM_TIME_STEP);
+			r += (u64)player.speed;
+		}
+		return r;
+	});
+
+	// driving down the middle of the track at about 30 m/s, the cursor follows like in the game
+	Track track;
+	track.generate(0.5f, 1);
+	std::vector<vec2> path;
+	for (TrackSegment &s : track.segments) {
+		for (float y = 0.0f; y < s.dims.y; y += 0.5f) path.push_back(s.p + y * s.dir);
+	}
+	runBench("player_check_track", "", [&](int n) {
+		u64 r = 0;
+		for (int i = 0; i < n; i++) {
+			size_t pi = (size_t)i % path.size();
+			if (pi == 0) player.respawn(v3(path[0], 50.0f), v2(0.0f, 1.0f));
+			player.position = v3(path[pi], player.position.z);
+			player.checkTrack(&track);
+			r += player.centerOnTrack ? 1 : 0;
+		}
+		return r;
+	});
+}
+
+// one op: every pickup of the set against the player, like a game without segment_pickups
+static void benchPickups() {
+	char params[64];
+	int pickup_counts[] = {1024, 16384, 262144};
+	for (int pickup_count : pickup_counts) {
+		RandomStream random(4);
+		std::vector<Pickup> pickups;
+		for (int i = 0; i < pickup_count; i++) {
+			PickupType type = random.nextf() < 0.5f ? PT_GAS_TANK : PT_OIL_SPILL;
+			pickups.push_back(Pickup(type, v3(random.rangef(-1000.0f, 1000.0f), random.rangef(-1000.0f, 1000.0f), 50.0f)));
+		}
+		std::vector<vec3> positions(1024);
+		for (vec3 &p : positions) p = v3(random.rangef(-1000.0f, 1000.0f), random.rangef(-1000.0f, 1000.0f), 50.0f);
+		Player player;
+		player.init();
+		snprintf(params, sizeof(params), "\"pickups\": %d", pickup_count);
+		runBench("pickup_try_collect", params, [&](int n) {
+			u64 r = 0;
+			for (int i = 0; i < n; i++) {
+				player.position = positions[(size_t)(i & 1023)];
+				for (Pickup &p : pickups) p.tryCollect(&player);
+				r += (u64)(player.fuel * 1000.0f);
+			}
+			return r;
+		});
+	}
+}
+
+static void benchMeshes() {
+	char params[128];
+	float difficulties[] = {0.0f, 0.5f, 1.0f};
+	for (float difficulty : difficulties) {
+		Track track;
+		track.generate(difficulty, 1);
+		snprintf(params, sizeof(params), "\"difficulty\": %.2f, \"segments\": %d, \"pickups\": %d", (double)difficulty,
+			(int)track.segments.size(), (int)track.pickups.size());
+
+		// a copy of the pickup models per pickup, the part of the build that grows with the pickups
+		PickupBatch batch;
+		std::vector<float> vertices(batch.build(&track, track.segments.front().p, nullptr));
+		runBench("pickup_batch_build", params, [&](int n) {
+			u64 r = 0;
+			for (int i = 0; i < n; i++) r += batch.build(&track, track.segments.front().p, vertices.data());
+			return r;
+		});
+
+		TrackMesh mesh;
+		runBench("track_mesh_build", params, [&](int n) {
+			u64 r = 0;
+			for (int i = 0; i < n; i++) {
+				mesh.build(&track);
+				r += mesh.vertex_size;
+			}
+			return r;
+		});
+		mesh.destroy();
+	}
+}
+
+int main(int argc, char *argv[]) {
+	profiler.init();
+	profiler.setThreadName("main");
+	const char *out_filename = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--filter") == 0 && i+1 < argc) {
+			bench_filter = argv[++i];
+		} else if (strcmp(argv[i], "--min-time") == 0 && i+1 < argc) {
+			bench_min_time = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--out") == 0 && i+1 < argc) {
+			out_filename = argv[++i];
+		} else {
+			LOGE("usage: %s [--filter name] [--min-time seconds] [--out file.json]", argv[0]);
+			return 1;
+		}
+	}
+	bench_out = stdout;
+	if (out_filename) {
+		bench_out = fopen(out_filename, "w");
+		if (!bench_out) {
+			LOGE("Could not write %s", out_filename);
+			return 1;
+		}
+	}
+
+	asset_archive.open("data.pak"); // next to data/, which is used without it
+	Pickup::loadMeshes(); // pickup_batch_build copies their vertices
+
+	fprintf(bench_out, "{\n\t\"context\": {\"simd\": \"%s\", \"threads\": %u, \"pickup_mesh_vertices\": [%d, %d]},\n\t\"benchmarks\": [",
+#ifdef __SSE2__
+		"sse2",
+#else
+		"scalar",
+#endif
+		std::thread::hardware_concurrency(), pickup_meshes[PT_GAS_TANK].vertex_count, pickup_meshes[PT_OIL_SPILL].vertex_count);
+	benchTrackGenerate();
+	benchTrackQueries();
+	benchPlayer();
+	benchPickups();
+	benchMeshes();
+	fprintf(bench_out, "\n\t]\n}\n");
+
+	if (out_filename) fclose(bench_out);
+	asset_archive.close();
+	return 0;
+}
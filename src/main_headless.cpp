@@ -0,0 +1,221 @@
+/*
+runs the simulation without a window or a gl context
+build with ./build.sh headless
+*/
+
+#include <assert.h>
+#include <time.h> // used by log
+#include <math.h> // for fabsf
+#include <float.h> // for FLT_MAX
+#ifdef __SSE2__
+	#include <emmintrin.h> // batched track queries
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+
+// gamelib
+#include <system/defines.h>
+#include <system/log.h>
+#include <math/random.h>
+#include <math/vector_math.h>
+#include <math/trigonometry.h>
+#include <math/transform.h>
+#include <input/input.h>
+#include <video/video_mode.h>
+#include <video/camera.h>
+
+#include <math/transform.cpp>
+#include <system/log.cpp>
+
+#include "random_stream.h"
+#include "profiler.h"
+#include "memory_stats.h"
+#include "balance.h"
+#include "particles.h"
+#include "track_cursor.h"
+#include "player.h"
+#include "pickup.h"
+#include "track_collision.h"
+#include "track.h"
+#include "track_generator.h"
+#include "autopilot.h"
+#include "replay.h"
+#include "game.h"
+
+#include "profiler.cpp"
+#include "memory_stats.cpp"
+#include "particles.cpp"
+#include "player.cpp"
+#include "pickup.cpp"
+#include "track.cpp"
+#include "track_collision.cpp"
+#include "track_cursor.cpp"
+#include "track_generator.cpp"
+#include "autopilot.cpp"
+#include "replay.cpp"
+#include "game.cpp"
+
+static double getTime() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + 1.0e-9 * (double)ts.tv_nsec;
+}
+
+// compares the reference height query with the precomputed scalar and batched ones
+static void benchTrackQueries() {
+	const int PROBE_COUNT = 4096;
+	const int REPEAT_COUNT = 256;
+
+	Track track;
+	track.generate(0.5f, 1);
+	RandomStream random(2);
+	std::vector<vec2> points(PROBE_COUNT);
+	std::vector<size_t> segments(PROBE_COUNT);
+	for (int i = 0; i < PROBE_COUNT; i++) {
+		// some of them next to the track
+		TrackSegment &s = track.segments[(size_t)(random.nextf() * (float)track.segments.size())];
+		points[i] = s.p + random.rangef(-0.6f, 0.6f) * s.dims.x * s.t + random.nextf() * s.dims.y * s.dir;
+		track.searchSegment(points[i], &segments[i]);
+	}
+	std::vector<float> z[3];
+	std::vector<bool> hits[3];
+	double times[3];
+	for (int k = 0; k < 3; k++) {
+		z[k].resize(PROBE_COUNT);
+		hits[k].resize(PROBE_COUNT);
+		bool batch_hits[PROBE_COUNT];
+		double begin_time = getTime();
+		for (int r = 0; r < REPEAT_COUNT; r++) {
+			if (k == 0) { // corners and cross products every time
+				for (int i = 0; i < PROBE_COUNT; i++) {
+					vec3 b0, b1, t0, t1; vec2 tdir;
+					track.getSegmentCorners(segments[i], &b0, &b1, &t0, &t1, &tdir);
+					batch_hits[i] = traceQuadZ(points[i], &z[k][i], b0, b1, t0, t1);
+				}
+			} else if (k == 1) {
+				for (int i = 0; i < PROBE_COUNT; i++) {
+					batch_hits[i] = track.collision.traceZ(segments[i], points[i], &z[k][i]);
+				}
+			} else {
+				track.collision.traceZ(PROBE_COUNT, &points[0], &segments[0], &z[k][0], batch_hits);
+			}
+		}
+		times[k] = getTime() - begin_time;
+		for (int i = 0; i < PROBE_COUNT; i++) hits[k][i] = batch_hits[i];
+	}
+
+	const char *names[3] = {"reference", "table", "batched"};
+	for (int k = 0; k < 3; k++) {
+		int mismatches = 0;
+		for (int i = 0; i < PROBE_COUNT; i++) {
+			if (hits[k][i] != hits[0][i] || (hits[0][i] && fabsf(z[k][i] - z[0][i]) > 0.001f)) mismatches++;
+		}
+		LOGI("%-9s %6.2f ns/query, %d mismatches", names[k],
+			1.0e9 * times[k] / (double)(PROBE_COUNT * REPEAT_COUNT), mismatches);
+	}
+}
+
+static void printMemoryReport(Game *game) {
+	MemoryReport report;
+	game->getMemoryUsage(&report);
+	report.addAssets(); // nothing is loaded without a renderer
+	report.print();
+}
+
+int main(int argc, char *argv[]) {
+	profiler.init();
+	profiler.setThreadName("main");
+	int tick_count = -1; // default: one minute of game time or the whole replay
+	u32 seed = 1;
+	GameMode mode = GM_LEVELS;
+	const char *record_filename = nullptr;
+	const char *replay_filename = nullptr;
+	bool print_memory = false;
+	bool use_autopilot = false;
+	const char *profile_filename = nullptr;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--ticks") == 0 && i+1 < argc) {
+			tick_count = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--seed") == 0 && i+1 < argc) {
+			seed = (u32)strtoul(argv[++i], nullptr, 10);
+		} else if (strcmp(argv[i], "--record") == 0 && i+1 < argc) {
+			record_filename = argv[++i];
+		} else if (strcmp(argv[i], "--replay") == 0 && i+1 < argc) {
+			replay_filename = argv[++i];
+		} else if (strcmp(argv[i], "--endless") == 0) {
+			mode = GM_ENDLESS;
+		} else if (strcmp(argv[i], "--autopilot") == 0) {
+			use_autopilot = true;
+		} else if (strcmp(argv[i], "--profile") == 0 && i+1 < argc) {
+			profile_filename = argv[++i];
+		} else if (strcmp(argv[i], "--memory") == 0) {
+			print_memory = true;
+		} else if (strcmp(argv[i], "--bench-track") == 0) {
+			benchTrackQueries();
+			return 0;
+		} else {
+			LOGE("usage: %s [--ticks n] [--seed n] [--endless] [--autopilot] [--record file] [--replay file] [--memory] [--profile trace.json] [--bench-track]", argv[0]);
+			return 1;
+		}
+	}
+
+	if (profile_filename) profiler.enabled = true;
+	Game *game = new Game();
+	game->seed = seed;
+	game->mode = mode;
+	ReplayReader replay;
+	if (replay_filename) {
+		if (!replay.open(replay_filename)) return 1;
+		game->replay = &replay;
+		game->seed = replay.seed;
+		game->mode = (GameMode)replay.mode;
+	} else if (tick_count < 0) {
+		tick_count = 60 * 60;
+	}
+	Autopilot autopilot;
+	if (use_autopilot && !replay_filename) game->autopilot = &autopilot;
+	ReplayWriter recording;
+	if (record_filename) {
+		if (!recording.open(record_filename, game->seed, (u8)game->mode)) return 1;
+		game->recording = &recording;
+	}
+	game->init();
+
+	// as fast as possible
+	int ticks = 0;
+	int reported_level = game->level;
+	double begin_time = getTime();
+	while (ticks != tick_count) {
+		game->update(SIM_TIME_STEP);
+		if (game->quit) break; // replay is over
+		ticks++;
+		if (print_memory && game->level != reported_level) { // should stay flat from level to level
+			reported_level = game->level;
+			LOGI("level %d after %d ticks:", game->level, ticks);
+			printMemoryReport(game);
+		}
+	}
+	double elapsed_time = getTime() - begin_time;
+
+	LOGI("%d ticks in %.3f s (%.0f ticks/s, %.0fx real time)", ticks, elapsed_time,
+		(double)ticks / elapsed_time, (double)ticks * (double)SIM_TIME_STEP / elapsed_time);
+	LOGI("seed: %u, level: %d, distance: %.1f m, fuel: %.3f, gameover: %d", game->seed,
+		game->level, (double)game->player.distance, (double)game->player.fuel, game->gameover);
+	if (game->autopilot) LOGI("autopilot: %d games started", game->run);
+	if (print_memory) printMemoryReport(game);
+	if (profile_filename) profiler.writeTrace(profile_filename);
+
+	recording.close();
+	replay.close();
+	game->destroy();
+	delete game;
+	return 0;
+}
@@ -0,0 +1,229 @@
+/*
+runs the game and its renderer against the null gl backend (gl_null.cpp)
+no window, no driver: every frame is one update and one draw
+prints draw calls, binds and upload bytes per frame to catch render regressions
+build with ./build.sh nullgl, run from build/ like the game
+*/
+
+#include <assert.h>
+#include <time.h> // used by log
+#include <math.h> // for fabsf
+#include <float.h> // for FLT_MAX
+#include <stddef.h> // for offsetof
+#ifdef __SSE2__
+	#include <emmintrin.h> // batched track queries
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h> // asset archive
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm> // for sort
+
+// only the prototypes, gl_null.cpp defines them
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+
+// fontstash
+#include <fontstash.h>
+
+// gamelib
+#include <system/defines.h>
+#include <system/files.h>
+#include <system/log.h>
+#include <math/random.h>
+#include <math/vector_math.h>
+#include <math/trigonometry.h>
+#include <math/transform.h>
+#include <input/input.h>
+#include <video/video_mode.h>
+#include <video/camera.h>
+#include <video/shader.h>
+#include <video/debug_renderer.h>
+#include <video/image.h>
+#include <video/texture.h>
+#include <video/model_mdl.h>
+
+#include <math/transform.cpp>
+#include <system/files.cpp>
+#include <system/log.cpp>
+#include <video/camera.cpp>
+#include <video/shader.cpp>
+#include <video/debug_renderer.cpp>
+#include <video/image.cpp>
+#include <video/texture.cpp>
+#include <video/texture_null.cpp>
+#include <video/model_mdl.cpp>
+
+#include "gl_null.h"
+#include "random_stream.h"
+#include "profiler.h"
+#include "memory_stats.h"
+#include "asset_archive.h"
+#include "asset_loader.h"
+#include "balance.h"
+#include "particles.h"
+#include "track_cursor.h"
+#include "player.h"
+#include "pickup.h"
+#include "track_collision.h"
+#include "track.h"
+#include "track_generator.h"
+#include "autopilot.h"
+#include "static_mesh.h"
+#include "texture_image.h"
+#include "render_queue.h"
+#include "pickup_render.h"
+#include "track_render.h"
+#include "hud_render.h"
+#include "replay.h"
+#include "game.h"
+
+#include "gl_null.cpp"
+#include "profiler.cpp"
+#include "memory_stats.cpp"
+#include "asset_archive.cpp"
+#include "asset_loader.cpp"
+#include "particles.cpp"
+#include "player.cpp"
+#include "pickup.cpp"
+#include "track.cpp"
+#include "track_collision.cpp"
+#include "track_cursor.cpp"
+#include "track_generator.cpp"
+#include "autopilot.cpp"
+#include "replay.cpp"
+#include "game.cpp"
+
+#include "render_queue.cpp"
+#include "static_mesh.cpp"
+#include "texture_image.cpp"
+#include "memory_stats_render.cpp"
+#include "particles_render.cpp"
+#include "pickup_render.cpp"
+#include "track_render.cpp"
+#include "player_render.cpp" // culls like the track
+#include "game_render.cpp"
+#include "hud_render.cpp"
+
+static void printStats(const char *label, const GLNullStats &s, double divider) {
+	LOGI("%-4s %8.1f draws %9.1f vertices %6.1f programs %6.1f buffers %6.1f textures (%.1f redundant) "
+		"%7.1f uniforms %7.1f state %8.1f KB buffers %8.1f KB textures", label,
+		(double)s.draw_calls / divider, (double)s.vertices / divider, (double)s.program_binds / divider,
+		(double)s.buffer_binds / divider, (double)s.texture_binds / divider, (double)s.redundant_binds / divider,
+		(double)s.uniform_uploads / divider, (double)s.state_changes / divider,
+		(double)s.buffer_bytes / divider / 1024.0, (double)s.texture_bytes / divider / 1024.0);
+}
+
+int main(int argc, char *argv[]) {
+	profiler.init();
+	profiler.setThreadName("main");
+	int frame_count = -1; // default: one minute or the whole replay
+	u32 seed = 1;
+	GameMode mode = GM_LEVELS;
+	const char *replay_filename = nullptr;
+	int max_draw_calls = -1; // fail if any frame needs more
+	bool use_autopilot = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--frames") == 0 && i+1 < argc) {
+			frame_count = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--seed") == 0 && i+1 < argc) {
+			seed = (u32)strtoul(argv[++i], nullptr, 10);
+		} else if (strcmp(argv[i], "--replay") == 0 && i+1 < argc) {
+			replay_filename = argv[++i];
+		} else if (strcmp(argv[i], "--endless") == 0) {
+			mode = GM_ENDLESS;
+		} else if (strcmp(argv[i], "--autopilot") == 0) {
+			use_autopilot = true;
+		} else if (strcmp(argv[i], "--max-draw-calls") == 0 && i+1 < argc) {
+			max_draw_calls = atoi(argv[++i]);
+		} else {
+			LOGE("usage: %s [--frames n] [--seed n] [--endless] [--autopilot] [--replay file] [--max-draw-calls n]", argv[0]);
+			return 1;
+		}
+	}
+
+	Game *game = new Game();
+	game->seed = seed;
+	game->mode = mode;
+	ReplayReader replay;
+	if (replay_filename) {
+		if (!replay.open(replay_filename)) return 1;
+		game->replay = &replay;
+		game->seed = replay.seed;
+		game->mode = (GameMode)replay.mode;
+	} else if (frame_count < 0) {
+		frame_count = 60 * 60;
+	}
+	Autopilot autopilot;
+	if (use_autopilot && !replay_filename) game->autopilot = &autopilot;
+
+	// same defaults as the sdl build
+	game->video.width = 1024;
+	game->video.height = 640;
+	game->video.fullscreen = false;
+	game->video.pixel_scale = 1.0f;
+	glViewport(0, 0, game->video.width, game->video.height); // like the sdl build does for its window
+
+	debug_renderer.init();
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	asset_archive.open("data.pak"); // next to data/, which is used without it
+	game->initRender();
+	game->init();
+	int loading_frames = 0;
+	while (game->loading) {
+		game->drawLoadingScreen();
+		loading_frames++;
+		if (game->loading) std::this_thread::sleep_for(std::chrono::milliseconds(16)); // about a frame
+	}
+	GLNullStats init_stats = gl_null_frame; // asset uploads, all loading frames together
+	gl_null_frame = GLNullStats();
+
+	int frames = 0;
+	RenderQueueStats queue_total;
+	while (frames != frame_count) {
+		game->update(SIM_TIME_STEP);
+		if (game->quit) break; // replay is over
+		game->draw(1.0f, SIM_TIME_STEP);
+		glNullEndFrame();
+		queue_total.commands += render_queue.stats.commands;
+		queue_total.skipped_binds += render_queue.stats.skipped_binds;
+		queue_total.skipped_uniforms += render_queue.stats.skipped_uniforms;
+		frames++;
+	}
+
+	LOGI("%d loading frames", loading_frames);
+	LOGI("%d frames, seed: %u, level: %d, distance: %.1f m", frames, game->seed, game->level, (double)game->player.distance);
+	printStats("init", init_stats, 1.0);
+	if (frames > 0) printStats("avg", gl_null_total, (double)frames);
+	printStats("max", gl_null_max, 1.0);
+	if (frames > 0) {
+		LOGI("render queue: %.1f commands, %.1f binds and %.1f uniform uploads skipped per frame",
+			(double)queue_total.commands / (double)frames, (double)queue_total.skipped_binds / (double)frames,
+			(double)queue_total.skipped_uniforms / (double)frames);
+	}
+
+	replay.close();
+	game->destroy(); // stops the track generator before its meshes go away
+	game->destroyRender();
+	asset_archive.close();
+	debug_renderer.destroy();
+	delete game;
+
+	if (max_draw_calls >= 0 && (int)gl_null_max.draw_calls > max_draw_calls) {
+		LOGE("%u draw calls in one frame, more than the allowed %d", gl_null_max.draw_calls, max_draw_calls);
+		return 1;
+	}
+	return 0;
+}
@@ -2,9 +2,23 @@
 #include <time.h> // used by log
 #include <math.h> // for fabsf
 #include <float.h> // for FLT_MAX
+#include <stddef.h> // for offsetof
+#ifdef __SSE2__
+	#include <emmintrin.h> // batched track queries
+#endif
 #include <stdlib.h>
 #include <unistd.h>
+#include <fcntl.h> // asset archive
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm> // for sort
 
 // SDL2
 #include <SDL.h>
@@ -67,16 +81,55 @@
 
 
 
+#include "random_stream.h"
+#include "profiler.h"
+#include "memory_stats.h"
+#include "asset_archive.h"
+#include "asset_loader.h"
+#include "balance.h"
+#include "particles.h"
+#include "track_cursor.h"
 #include "player.h"
 #include "pickup.h"
+#include "track_collision.h"
 #include "track.h"
+#include "track_generator.h"
+#include "autopilot.h"
+#include "static_mesh.h"
+#include "texture_image.h"
+#include "render_queue.h"
+#include "pickup_render.h"
+#include "track_render.h"
+#include "hud_render.h"
+#include "replay.h"
 #include "game.h"
 
+#include "profiler.cpp"
+#include "memory_stats.cpp"
+#include "asset_archive.cpp"
+#include "asset_loader.cpp"
+#include "particles.cpp"
 #include "player.cpp"
 #include "pickup.cpp"
 #include "track.cpp"
+#include "track_collision.cpp"
+#include "track_cursor.cpp"
+#include "track_generator.cpp"
+#include "autopilot.cpp"
+#include "replay.cpp"
 #include "game.cpp"
 
+#include "render_queue.cpp"
+#include "static_mesh.cpp"
+#include "texture_image.cpp"
+#include "memory_stats_render.cpp"
+#include "particles_render.cpp"
+#include "pickup_render.cpp"
+#include "track_render.cpp"
+#include "player_render.cpp" // culls like the track
+#include "game_render.cpp"
+#include "hud_render.cpp"
+
 const char *WINDOW_TITLE = "Ludum Dare 39";
 SDL_Window *sdl_window;
 SDL_GLContext sdl_gl_context;
@@ -262,14 +315,74 @@ void FrameTime::drawInfo() {
 #endif
 }
 
+static bool compareEventBegin(const ProfileEvent &a, const ProfileEvent &b) {
+	return a.begin < b.begin;
+}
+
+// scopes of the last frame on the main thread, the last second on the others
+void Profiler::drawInfo() {
+#ifdef DEBUG
+	ImGui::Begin("profiler");
+	bool is_enabled = enabled;
+	if (ImGui::Checkbox("enabled", &is_enabled)) enabled = is_enabled;
+	ImGui::SameLine();
+	if (ImGui::Button("write trace.json")) writeTrace("trace.json");
+
+	u64 t = now();
+	std::lock_guard<std::mutex> lock(threads_mutex);
+	std::vector<ProfileEvent> events;
+	for (ProfileThread *thread : threads) {
+		u64 begin = thread == frame_thread ? last_frame_begin : (t > 1000000000 ? t - 1000000000 : 0);
+		u64 end = thread == frame_thread ? last_frame_end : t;
+		events.clear();
+		{
+			std::lock_guard<std::mutex> thread_lock(thread->mutex);
+			u64 count = thread->event_count < PROFILER_RING_SIZE ? thread->event_count : PROFILER_RING_SIZE;
+			for (u64 i = thread->event_count - count; i < thread->event_count; i++) {
+				ProfileEvent &e = thread->events[i % PROFILER_RING_SIZE];
+				if (e.begin >= begin && e.end <= end) events.push_back(e);
+			}
+		}
+		std::sort(events.begin(), events.end(), compareEventBegin); // parents end after their children
+
+		ImGui::Separator();
+		ImGui::Text("%s", thread->name);
+		for (ProfileEvent &e : events) {
+			ImGui::Text("%*s%-24s %8.3f ms", 2 * e.depth, "", e.name, 1.0e-6 * (double)(e.end - e.begin));
+		}
+	}
+	ImGui::End();
+#endif
+}
+
+void MemoryReport::drawInfo() {
+#ifdef DEBUG
+	ImGui::Text("memory (KB)      cpu  buffers textures");
+	for (int i = 0; i < MT_COUNT; i++) {
+		ImGui::Text("%-14s %7.1f %8.1f %8.1f", memory_tag_names[i], (double)usage[i].cpu / 1024.0,
+			(double)usage[i].gpu_buffers / 1024.0, (double)usage[i].gpu_textures / 1024.0);
+	}
+	MemoryUsage sum = total();
+	ImGui::Text("%-14s %7.1f %8.1f %8.1f", "total", (double)sum.cpu / 1024.0,
+		(double)sum.gpu_buffers / 1024.0, (double)sum.gpu_textures / 1024.0);
+#endif
+}
+
 Game *game;
 
+const float MAX_FRAME_TIME = 0.25f; // don't try to catch up after long stalls
+const double FALLBACK_FRAME_TIME = 1.0 / 60.0; // frame rate cap without vsync
+Uint64 last_frame_counter;
+float sim_time_accumulator = 0.0f;
+
 void mainLoop() {
-	keyboard.beginFrame();
-	for (int gi = 0; gi < (int)ARRAY_COUNT(gamepads); gi++) {
-		gamepads[gi].beginFrame();
-	}
+	profiler.beginFrame();
+	Uint64 frame_counter = SDL_GetPerformanceCounter();
+	float frame_time = (float)((double)(frame_counter - last_frame_counter) / (double)SDL_GetPerformanceFrequency());
+	last_frame_counter = frame_counter;
+	if (frame_time > MAX_FRAME_TIME) frame_time = MAX_FRAME_TIME;
 
+	ProfileScope input_scope("poll input");
 	SDL_Event sdl_event;
 	while (SDL_PollEvent(&sdl_event)) {
 #ifdef DEBUG
@@ -312,24 +425,88 @@ void mainLoop() {
 			break;
 		}
 	}
+	input_scope.end();
 
 #ifdef DEBUG
 	ImGui_ImplSdlGL2_NewFrame();
 #endif
 
-	game->tick(1.0f / 60.0f /*(float)frametime.smoothed_frame_time*/);
+	if (game->loading) { // the game starts once everything is there
+		game->drawLoadingScreen();
+	} else {
+		// advance the simulation in fixed steps, render whatever is left as interpolation
+		sim_time_accumulator += frame_time;
+		while (sim_time_accumulator >= SIM_TIME_STEP) {
+			game->update(SIM_TIME_STEP);
+			sim_time_accumulator -= SIM_TIME_STEP;
+
+			// each button press is seen by exactly one update
+			keyboard.beginFrame();
+			for (int gi = 0; gi < (int)ARRAY_COUNT(gamepads); gi++) {
+				gamepads[gi].beginFrame();
+			}
+		}
+		game->draw(sim_time_accumulator / SIM_TIME_STEP, frame_time);
+	}
 
 #ifdef DEBUG
+	profiler.drawInfo();
 	frametime.drawInfo();
+	MemoryReport memory_report;
+	game->getMemoryUsage(&memory_report);
+	game->getRenderMemoryUsage(&memory_report);
+	memory_report.addAssets();
+	memory_report.drawInfo();
 	ImGui::Render();
 #endif
 
+	PROFILE_SCOPE("SDL_GL_SwapWindow");
 	SDL_GL_SwapWindow(sdl_window);
 	frametime.update();
 }
 
 int main(int argc, char *argv[]) {
+	profiler.init();
+	profiler.setThreadName("main");
 	game = new Game();
+	game->seed = (u32)time(nullptr);
+
+	// command line
+	const char *record_filename = nullptr;
+	const char *replay_filename = nullptr;
+	const char *profile_filename = nullptr;
+	bool use_autopilot = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--record") == 0 && i+1 < argc) {
+			record_filename = argv[++i];
+		} else if (strcmp(argv[i], "--replay") == 0 && i+1 < argc) {
+			replay_filename = argv[++i];
+		} else if (strcmp(argv[i], "--profile") == 0 && i+1 < argc) {
+			profile_filename = argv[++i];
+		} else if (strcmp(argv[i], "--endless") == 0) {
+			game->mode = GM_ENDLESS;
+		} else if (strcmp(argv[i], "--autopilot") == 0) {
+			use_autopilot = true;
+		} else {
+			LOGE("usage: %s [--endless] [--autopilot] [--record file] [--replay file] [--profile trace.json]", argv[0]);
+			exit(1);
+		}
+	}
+	if (profile_filename) profiler.enabled = true;
+	ReplayReader replay;
+	if (replay_filename) {
+		if (!replay.open(replay_filename)) exit(1);
+		game->replay = &replay;
+		game->seed = replay.seed;
+		game->mode = (GameMode)replay.mode;
+	}
+	Autopilot autopilot;
+	if (use_autopilot) game->autopilot = &autopilot;
+	ReplayWriter recording;
+	if (record_filename) {
+		if (!recording.open(record_filename, game->seed, (u8)game->mode)) exit(1);
+		game->recording = &recording;
+	}
 
 	// reasonable defaults
 	game->video.width = 1024;
@@ -359,26 +536,35 @@ int main(int argc, char *argv[]) {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	asset_archive.open("data.pak"); // next to data/, which is used without it
+	game->initRender();
 	game->init();
 
 	// init this last for sake of last_ticks
 	frametime.init();
+	last_frame_counter = SDL_GetPerformanceCounter();
 
 #ifdef __EMSCRIPTEN__
 	emscripten_set_main_loop(mainLoop, 0, 1);
 #else
+	bool vsync = SDL_GL_GetSwapInterval() == 1; // off on the rpi and where the driver refused
 	do {
-		Uint32 beginTicks = SDL_GetTicks();
+		Uint64 begin_counter = SDL_GetPerformanceCounter();
 		mainLoop();
-		// hack for when vsync isn't working
-		Uint32 elapsedTicks = SDL_GetTicks() - beginTicks;
-		if (elapsedTicks < 16) {
-			SDL_Delay(16 - elapsedTicks);
+		if (!vsync) { // sleep away the rest of the frame, the accumulator keeps the game speed right anyway
+			double elapsed = (double)(SDL_GetPerformanceCounter() - begin_counter) / (double)SDL_GetPerformanceFrequency();
+			if (elapsed < FALLBACK_FRAME_TIME) SDL_Delay((Uint32)(1000.0 * (FALLBACK_FRAME_TIME - elapsed)));
 		}
 	} while (!game->quit);
 #endif
 
-	game->destroy();
+	recording.close();
+	replay.close();
+	if (profile_filename) profiler.writeTrace(profile_filename);
+
+	game->destroy(); // stops the track generator before its meshes go away
+	game->destroyRender();
+	asset_archive.close();
 	debug_renderer.destroy();
 #ifdef DEBUG
 	ImGui_ImplSdlGL2_Shutdown();
@@ -0,0 +1,49 @@
+static const char *memory_tag_names[MT_COUNT] = {
+	"track",
+	"pickups",
+	"models",
+	"fonts",
+	"particles",
+	"hud"
+};
+
+static MemoryUsage asset_usage[MT_COUNT];
+
+void trackAsset(MemoryTag tag, size_t cpu, size_t gpu_buffers, size_t gpu_textures) {
+	asset_usage[tag].cpu += cpu;
+	asset_usage[tag].gpu_buffers += gpu_buffers;
+	asset_usage[tag].gpu_textures += gpu_textures;
+}
+
+void MemoryReport::add(MemoryTag tag, size_t cpu, size_t gpu_buffers, size_t gpu_textures) {
+	usage[tag].cpu += cpu;
+	usage[tag].gpu_buffers += gpu_buffers;
+	usage[tag].gpu_textures += gpu_textures;
+}
+
+void MemoryReport::addAssets() {
+	for (int i = 0; i < MT_COUNT; i++) {
+		add((MemoryTag)i, asset_usage[i].cpu, asset_usage[i].gpu_buffers, asset_usage[i].gpu_textures);
+	}
+}
+
+MemoryUsage MemoryReport::total() {
+	MemoryUsage sum;
+	for (int i = 0; i < MT_COUNT; i++) {
+		sum.cpu += usage[i].cpu;
+		sum.gpu_buffers += usage[i].gpu_buffers;
+		sum.gpu_textures += usage[i].gpu_textures;
+	}
+	return sum;
+}
+
+void MemoryReport::print() {
+	LOGI("%-14s %10s %10s %10s", "memory (KB)", "cpu", "buffers", "textures");
+	for (int i = 0; i < MT_COUNT; i++) {
+		LOGI("%-14s %10.1f %10.1f %10.1f", memory_tag_names[i], (double)usage[i].cpu / 1024.0,
+			(double)usage[i].gpu_buffers / 1024.0, (double)usage[i].gpu_textures / 1024.0);
+	}
+	MemoryUsage sum = total();
+	LOGI("%-14s %10.1f %10.1f %10.1f", "total", (double)sum.cpu / 1024.0,
+		(double)sum.gpu_buffers / 1024.0, (double)sum.gpu_textures / 1024.0);
+}
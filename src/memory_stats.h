@@ -0,0 +1,39 @@
+/*
+memory in use per subsystem, to catch growth across levels
+containers are counted by capacity when a report is made, opaque things
+(gamelib models, fontstash, gpu storage) are estimated
+*/
+
+enum MemoryTag {
+	MT_TRACK,
+	MT_PICKUPS,
+	MT_MODELS,
+	MT_FONTS,
+	MT_PARTICLES,
+	MT_HUD,
+	MT_COUNT
+};
+
+struct MemoryUsage {
+	size_t cpu = 0;
+	size_t gpu_buffers = 0;
+	size_t gpu_textures = 0;
+};
+
+template <typename T>
+inline size_t vectorBytes(const std::vector<T> &v) {
+	return sizeof(T) * v.capacity();
+}
+
+struct MemoryReport {
+	MemoryUsage usage[MT_COUNT];
+
+	void add(MemoryTag tag, size_t cpu, size_t gpu_buffers = 0, size_t gpu_textures = 0);
+	void addAssets(); // everything registered with trackAsset
+	MemoryUsage total();
+	void print(); // to the log
+	void drawInfo(); // DEBUG ImGui, next to FrameTime::drawInfo
+};
+
+// for assets whose memory doesn't change once loaded
+void trackAsset(MemoryTag tag, size_t cpu, size_t gpu_buffers = 0, size_t gpu_textures = 0);
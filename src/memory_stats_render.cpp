@@ -0,0 +1,40 @@
+// bytes of a texture's base level, 0 where gles can't tell
+static size_t estimateTextureSize(GLuint texture) {
+#if defined(USE_OPENGLES) || defined(__EMSCRIPTEN__)
+	return 0;
+#else
+	GLint width = 0, height = 0;
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return 4 * (size_t)width * (size_t)height; // rgba
+#endif
+}
+
+// vertex and triangle chunks of the file end up in gpu buffers, the rest (skeleton, actions) stays
+void trackModel(MDLModel *model, const char *filename) {
+	AssetData asset;
+	asset.load(filename);
+	size_t file_size = asset.size;
+	size_t buffer_size = 0;
+	if (file_size >= 16) {
+		u32 header[4]; // magic, version, file size, chunk count
+		memcpy(header, asset.data, sizeof(header));
+		size_t offset = sizeof(header);
+		for (u32 i = 0; i < header[3] && offset + 12 <= file_size; i++) {
+			u32 chunk[3]; // type, size, count
+			memcpy(chunk, asset.data + offset, sizeof(chunk));
+			if (memcmp(&chunk[0], "VTX1", 4) == 0 || memcmp(&chunk[0], "TRI1", 4) == 0) buffer_size += chunk[1];
+			if (chunk[1] == 0) break;
+			offset += chunk[1];
+		}
+	}
+
+	size_t texture_size = 0;
+	for (int i = 0; i < (int)ARRAY_COUNT(model->textures); i++) {
+		if (model->textures[i]) texture_size += estimateTextureSize(model->textures[i]);
+	}
+	trackAsset(MT_MODELS, sizeof(MDLModel) + file_size - (buffer_size < file_size ? buffer_size : file_size),
+		buffer_size, texture_size);
+}
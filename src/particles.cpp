@@ -0,0 +1,86 @@
+const ParticleLook particle_looks[PK_COUNT] = {
+	// fire: rises and grows, gone by the time the player respawns
+	{24, 1.0f, 5.0f, v3(1.0f, 1.0f, 0.6f), 0.4f, EXPLOSION_DURATION, 2.0f, 2.5f, 1.5f, 5.0f, 4.0f,
+		{255, 255, 255, 255}, {255, 255, 255, 0}},
+	// oil: dark drops thrown up from under the car
+	{12, 2.0f, 4.0f, v3(0.5f, 0.5f, 1.0f), 0.4f, 0.7f, -10.0f, 0.5f, 0.6f, 0.3f, 8.0f,
+		{40, 30, 20, 255}, {20, 15, 10, 0}},
+};
+
+void ParticleSystem::clear(u64 seed) {
+	count = 0;
+	random.seed(seed, STREAM_PARTICLES);
+}
+
+void ParticleSystem::emit(ParticleKind k, vec3 position, vec3 velocity) {
+	const ParticleLook &look = particle_looks[k];
+	for (int n = 0; n < look.burst_count && count < PARTICLE_CAPACITY; n++) {
+		int i = count++;
+		// upper half of a sphere
+		vec3 dir = v3(random.rangef(-1.0f, 1.0f), random.rangef(-1.0f, 1.0f), random.nextf());
+		float len = length(dir);
+		dir = len > 0.001f ? dir / len : v3(0.0f, 0.0f, 1.0f);
+		vec3 v = velocity + random.rangef(look.speed_min, look.speed_max) * v3(dir.x * look.spread.x, dir.y * look.spread.y, dir.z * look.spread.z);
+		x[i] = prev_x[i] = position.x;
+		y[i] = prev_y[i] = position.y;
+		z[i] = prev_z[i] = position.z;
+		vx[i] = v.x;
+		vy[i] = v.y;
+		vz[i] = v.z;
+		gravity[i] = look.gravity;
+		damping[i] = fmaxf(0.0f, 1.0f - look.drag * SIM_TIME_STEP);
+		age[i] = 0.0f;
+		life[i] = random.rangef(look.life_min, look.life_max);
+		rotation[i] = random.rangef(0.0f, 2.0f * (float)M_PI);
+		spin[i] = random.rangef(-look.spin, look.spin);
+		kind[i] = (u8)k;
+	}
+}
+
+// damping is per SIM_TIME_STEP, the game ticks in exactly those
+void ParticleSystem::tick(float delta_time) {
+	int n = count;
+	memcpy(prev_x, x, sizeof(float) * (size_t)n);
+	memcpy(prev_y, y, sizeof(float) * (size_t)n);
+	memcpy(prev_z, z, sizeof(float) * (size_t)n);
+	for (int i = 0; i < n; i++) {
+		vx[i] *= damping[i];
+		vy[i] *= damping[i];
+		vz[i] = damping[i] * vz[i] + delta_time * gravity[i];
+	}
+	for (int i = 0; i < n; i++) {
+		x[i] += delta_time * vx[i];
+		y[i] += delta_time * vy[i];
+		z[i] += delta_time * vz[i];
+	}
+	for (int i = 0; i < n; i++) age[i] += delta_time;
+
+	// the last live particle takes the place of a dead one
+	for (int i = n-1; i >= 0; i--) {
+		if (age[i] < life[i]) continue;
+		int last = --count;
+		x[i] = x[last]; y[i] = y[last]; z[i] = z[last];
+		prev_x[i] = prev_x[last]; prev_y[i] = prev_y[last]; prev_z[i] = prev_z[last];
+		vx[i] = vx[last]; vy[i] = vy[last]; vz[i] = vz[last];
+		gravity[i] = gravity[last];
+		damping[i] = damping[last];
+		age[i] = age[last];
+		life[i] = life[last];
+		rotation[i] = rotation[last];
+		spin[i] = spin[last];
+		kind[i] = kind[last];
+	}
+}
+
+void ParticleSystem::translate(vec2 offset) {
+	for (int i = 0; i < count; i++) {
+		x[i] += offset.x;
+		y[i] += offset.y;
+		prev_x[i] += offset.x;
+		prev_y[i] += offset.y;
+	}
+}
+
+void ParticleSystem::getMemoryUsage(MemoryReport *report) {
+	report->add(MT_PARTICLES, sizeof(ParticleSystem));
+}
@@ -0,0 +1,55 @@
+/*
+pooled particles for effects like explosions and oil splashes
+fixed capacity, stored as a struct of arrays so ticking is a few flat loops
+ticked with the simulation and interpolated when drawn like the player,
+so an effect looks the same at any frame rate
+*/
+
+const int PARTICLE_CAPACITY = 256; // new particles are dropped while the pool is full
+
+enum ParticleKind {
+	PK_FIRE,
+	PK_OIL,
+	PK_COUNT
+};
+
+// how the particles of one kind start out and change over their life
+struct ParticleLook {
+	int burst_count; // particles per emit
+	float speed_min, speed_max; // m/s, random directions, scaled by spread
+	vec3 spread;
+	float life_min, life_max; // seconds
+	float gravity; // m/s², negative pulls down
+	float drag; // fraction of the velocity lost per second
+	float size_begin, size_end; // meters
+	float spin; // max rad/s, either direction
+	u8 color_begin[4], color_end[4];
+};
+
+extern const ParticleLook particle_looks[PK_COUNT];
+
+struct ParticleSystem {
+	int count = 0; // live particles are [0, count)
+	float x[PARTICLE_CAPACITY], y[PARTICLE_CAPACITY], z[PARTICLE_CAPACITY];
+	float prev_x[PARTICLE_CAPACITY], prev_y[PARTICLE_CAPACITY], prev_z[PARTICLE_CAPACITY]; // before the last tick
+	float vx[PARTICLE_CAPACITY], vy[PARTICLE_CAPACITY], vz[PARTICLE_CAPACITY];
+	float gravity[PARTICLE_CAPACITY];
+	float damping[PARTICLE_CAPACITY]; // velocity factor per tick
+	float age[PARTICLE_CAPACITY], life[PARTICLE_CAPACITY];
+	float rotation[PARTICLE_CAPACITY], spin[PARTICLE_CAPACITY]; // rotation at age 0
+	u8 kind[PARTICLE_CAPACITY];
+	RandomStream random; // only looks, never affects the game
+
+	void clear(u64 seed);
+	void emit(ParticleKind k, vec3 position, vec3 velocity); // a burst, velocity is added to every particle
+	void tick(float delta_time);
+	void translate(vec2 offset);
+	void getMemoryUsage(MemoryReport *report);
+
+	// render side (particles_render.cpp), not available in headless builds
+	static void loadTexture(); // cpu part of initRender, may run on another thread before it
+	static void initRender();
+	static void destroyRender();
+	void draw(Camera *camera, float alpha); // all live particles in one draw call
+	void getRenderMemoryUsage(MemoryReport *report);
+};
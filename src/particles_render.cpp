@@ -0,0 +1,164 @@
+// every particle is a billboard with the explosion model's texture
+static TextureImage explosion_image; // until initRender uploads it
+static GLuint explosion_texture;
+
+struct ParticleVertex {
+	float center[3];
+	float offset[2]; // from the center in meters, rotated, along the screen axes
+	u8 texcoord[2]; // normalized
+	u8 pad[2];
+	u8 color[4]; // normalized
+};
+
+const int PA_VA_CENTER = 0;
+const int PA_VA_OFFSET = 1;
+const int PA_VA_TEXCOORD = 2;
+const int PA_VA_COLOR = 3;
+
+static Shader particle_shader;
+static GLuint particle_program;
+static GLint particle_view_proj_loc;
+static GLint particle_scale_loc;
+static GLint particle_colormap_loc;
+static GLuint particle_vbo; // room for PARTICLE_CAPACITY quads, the live ones are rewritten every frame
+static GLuint particle_ibo; // the same two triangles for every quad
+static ParticleVertex particle_vertices[4 * PARTICLE_CAPACITY];
+
+void ParticleSystem::loadTexture() {
+	StaticMesh explosion_mesh; // only its material is used
+	explosion_mesh.load("data/models/explosion.mdl");
+	char filename[TEXTURE_FILENAME_SIZE];
+	if (getTextureFilename(explosion_mesh.material, filename, sizeof(filename))) explosion_image.load(filename);
+}
+
+void ParticleSystem::initRender() {
+	trackAsset(MT_PARTICLES, 0, 0, explosion_image.getTextureSize());
+	explosion_texture = explosion_image.upload(GL_NEAREST);
+
+	// offsets are scaled into clip space after the projection, so quads always face the screen
+	const char *vert_source =
+	"uniform mat4 view_proj;"
+	"uniform vec2 scale;" // projection scale of x and y
+	"attribute vec3 center;"
+	"attribute vec2 offset;"
+	"attribute vec2 texcoord;"
+	"attribute vec4 color;"
+	"varying vec2 v_texcoord;"
+	"varying vec4 v_color;"
+	"void main() {"
+	"\tv_texcoord = texcoord;"
+	"\tv_color = color;"
+	"\tgl_Position = view_proj * vec4(center, 1.0);"
+	"\tgl_Position.xy += scale * offset;"
+	"}";
+
+	const char *frag_source =
+	"#ifdef GL_ES\n"
+	"precision mediump float;\n"
+	"#endif\n"
+	"uniform sampler2D colormap;"
+	"varying vec2 v_texcoord;"
+	"varying vec4 v_color;"
+	"void main() {"
+	"\tvec4 color = v_color * texture2D(colormap, v_texcoord);"
+	"\tif (color.a < 0.01) discard;"
+	"\tgl_FragColor = color;"
+	"}";
+
+	particle_shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
+	particle_shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
+	particle_shader.bindVertexAttrib("center", PA_VA_CENTER);
+	particle_shader.bindVertexAttrib("offset", PA_VA_OFFSET);
+	particle_shader.bindVertexAttrib("texcoord", PA_VA_TEXCOORD);
+	particle_shader.bindVertexAttrib("color", PA_VA_COLOR);
+	particle_shader.link();
+	particle_shader.use();
+	particle_program = RenderQueue::getCurrentProgram();
+	particle_view_proj_loc = particle_shader.getUniformLocation("view_proj");
+	particle_scale_loc = particle_shader.getUniformLocation("scale");
+	particle_colormap_loc = particle_shader.getUniformLocation("colormap");
+
+	u16 indices[6 * PARTICLE_CAPACITY];
+	for (int i = 0; i < PARTICLE_CAPACITY; i++) {
+		u16 v = (u16)(4 * i);
+		u16 quad[6] = {v, (u16)(v+1), (u16)(v+2), v, (u16)(v+2), (u16)(v+3)};
+		memcpy(&indices[6 * i], quad, sizeof(quad));
+	}
+	glGenBuffers(1, &particle_ibo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, particle_ibo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glGenBuffers(1, &particle_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, particle_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(particle_vertices), nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void ParticleSystem::destroyRender() {
+	glDeleteTextures(1, &explosion_texture);
+	explosion_texture = 0;
+	particle_shader.destroy();
+	glDeleteBuffers(1, &particle_vbo);
+	glDeleteBuffers(1, &particle_ibo);
+	particle_vbo = particle_ibo = 0;
+}
+
+void ParticleSystem::draw(Camera *camera, float alpha) {
+	if (count == 0) return;
+
+	static const float corners[4][2] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+	static const u8 texcoords[4][2] = {{0, 0}, {255, 0}, {255, 255}, {0, 255}};
+	float draw_age_offset = (alpha - 1.0f) * SIM_TIME_STEP; // age is one tick ahead of alpha
+	ParticleVertex *v = particle_vertices;
+	for (int i = 0; i < count; i++) {
+		const ParticleLook &look = particle_looks[kind[i]];
+		float draw_age = fmaxf(0.0f, age[i] + draw_age_offset);
+		float t = fminf(1.0f, draw_age / life[i]);
+		float size = look.size_begin + t * (look.size_end - look.size_begin);
+		float angle = rotation[i] + draw_age * spin[i];
+		float c = size * cosf(angle);
+		float s = size * sinf(angle);
+		float center[3] = {
+			prev_x[i] + alpha * (x[i] - prev_x[i]),
+			prev_y[i] + alpha * (y[i] - prev_y[i]),
+			prev_z[i] + alpha * (z[i] - prev_z[i])
+		};
+		u8 color[4];
+		for (int ci = 0; ci < 4; ci++) {
+			color[ci] = (u8)((float)look.color_begin[ci] + t * ((float)look.color_end[ci] - (float)look.color_begin[ci]));
+		}
+		for (int k = 0; k < 4; k++) {
+			memcpy(v->center, center, sizeof(center));
+			v->offset[0] = c * corners[k][0] - s * corners[k][1];
+			v->offset[1] = s * corners[k][0] + c * corners[k][1];
+			v->texcoord[0] = texcoords[k][0];
+			v->texcoord[1] = texcoords[k][1];
+			memcpy(v->color, color, sizeof(color));
+			v++;
+		}
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, particle_vbo);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(4 * sizeof(ParticleVertex) * (size_t)count), particle_vertices);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// see through each other, without depth writes
+	RenderCommand *c = render_queue.add(RP_TRANSPARENT, particle_program, explosion_texture, 0.0f, 6 * count);
+	c->index_buffer = particle_ibo;
+	GLsizei stride = sizeof(ParticleVertex);
+	render_queue.setAttrib(c, PA_VA_CENTER, particle_vbo, 3, GL_FLOAT, GL_FALSE, stride, offsetof(ParticleVertex, center));
+	render_queue.setAttrib(c, PA_VA_OFFSET, particle_vbo, 2, GL_FLOAT, GL_FALSE, stride, offsetof(ParticleVertex, offset));
+	render_queue.setAttrib(c, PA_VA_TEXCOORD, particle_vbo, 2, GL_UNSIGNED_BYTE, GL_TRUE, stride, offsetof(ParticleVertex, texcoord));
+	render_queue.setAttrib(c, PA_VA_COLOR, particle_vbo, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offsetof(ParticleVertex, color));
+
+	// the projection scales offsets like it scales view space x and y
+	float scale_y = 1.0f / tanf(0.5f * camera->field_of_view);
+	float scale[2] = {scale_y / camera->aspect_ratio, scale_y};
+	render_queue.addUniform(c, particle_view_proj_loc, camera->view_proj_mat);
+	render_queue.addUniform(c, particle_scale_loc, RU_VEC2, scale);
+	render_queue.addUniform(c, particle_colormap_loc, 0);
+}
+
+void ParticleSystem::getRenderMemoryUsage(MemoryReport *report) {
+	report->add(MT_PARTICLES, sizeof(particle_vertices), sizeof(particle_vertices) + 6 * sizeof(u16) * PARTICLE_CAPACITY);
+}
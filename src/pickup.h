@@ -2,6 +2,7 @@ enum PickupType {
 	PT_GAS_TANK,
 	PT_OIL_SPILL
 };
+const int PT_COUNT = 2;
 
 class Pickup {
 public:
@@ -9,14 +10,13 @@ public:
 	bool active = true;
 	vec3 position;
 
-	float anim_time = 0.0f;
-
-	static MDLModel gas_tank_model;
-	static MDLModel oil_spill_model;
-
 	Pickup(PickupType t, vec3 pos) : type(t), position(pos) {}
 
 	void tryCollect(Player *p);
 
-	void draw(mat4 view_proj_mat);
+	// render side (pickup_render.cpp), pickups are drawn in batches per track, see PickupBatch
+	static void loadMeshes(); // cpu part of initRender, may run on another thread before it
+	static void loadTextures(); // the same, after loadMeshes
+	static void initRender();
+	static void destroyRender();
 };
\ No newline at end of file
@@ -0,0 +1,195 @@
+static StaticMesh pickup_meshes[PT_COUNT];
+static TextureImage pickup_images[PT_COUNT]; // of the meshes' materials, until initRender uploads them
+static GLuint pickup_textures[PT_COUNT];
+
+const int PU_VA_POSITION = 0;
+const int PU_VA_NORMAL = 1;
+const int PU_VA_TEXCOORD = 2;
+const int PU_VA_CENTER = 3;
+const int PU_VA_COLLECT_TIME = 4;
+
+const float PICKUP_NOT_COLLECTED = 1.0e9f; // collect time of active pickups
+
+static Shader pickup_shader;
+static GLuint pickup_program;
+static GLint pickup_mvp_loc;
+static GLint pickup_time_loc;
+static GLint pickup_anim_loc;
+static GLint pickup_colormap_loc;
+
+void Pickup::loadMeshes() {
+	pickup_meshes[PT_GAS_TANK].load("data/models/gas_tank.mdl");
+	pickup_meshes[PT_OIL_SPILL].load("data/models/oil_spill.mdl");
+}
+
+void Pickup::loadTextures() {
+	for (int type = 0; type < PT_COUNT; type++) {
+		char filename[TEXTURE_FILENAME_SIZE];
+		if (getTextureFilename(pickup_meshes[type].material, filename, sizeof(filename))) pickup_images[type].load(filename);
+	}
+}
+
+void Pickup::initRender() {
+	size_t texture_size = 0;
+	for (int type = 0; type < PT_COUNT; type++) {
+		texture_size += pickup_images[type].getTextureSize();
+		pickup_textures[type] = pickup_images[type].upload(GL_LINEAR);
+	}
+	trackAsset(MT_PICKUPS, vectorBytes(pickup_meshes[PT_GAS_TANK].vertices) + vectorBytes(pickup_meshes[PT_OIL_SPILL].vertices),
+		0, texture_size);
+
+	const char *vert_source =
+	"uniform mat4 mvp;"
+	"uniform float time;"
+	"uniform vec3 anim;" // x: spin speed, y: bob height, z: shrink speed once collected
+	"attribute vec3 position;"
+	"attribute vec3 normal;"
+	"attribute vec2 texcoord;"
+	"attribute vec3 center;"
+	"attribute float collect_time;"
+	"varying vec2 v_texcoord;"
+	"varying float v_shade;"
+	"void main() {"
+	"\tfloat since = time - collect_time;"
+	"\tfloat scale = since < 0.0 ? 1.0 : max(0.0, 1.0 - anim.z * since);"
+	"\tfloat c = cos(anim.x * time);"
+	"\tfloat s = sin(anim.x * time);"
+	"\tvec3 p = scale * vec3(c*position.x - s*position.y, s*position.x + c*position.y, position.z);"
+	"\tvec3 n = vec3(c*normal.x - s*normal.y, s*normal.x + c*normal.y, normal.z);"
+	"\tp.z += anim.y * (2.0 + sin(4.0 * time));"
+	"\tv_texcoord = texcoord;"
+	"\tv_shade = 0.75 + 0.25 * dot(n, -normalize(vec3(0.2, 0.3, -1.0)));"
+	"\tgl_Position = mvp * vec4(center + p, 1.0);"
+	"}";
+
+	const char *frag_source =
+	"#ifdef GL_ES\n"
+	"precision mediump float;\n"
+	"#endif\n"
+	"uniform sampler2D colormap;"
+	"varying vec2 v_texcoord;"
+	"varying float v_shade;"
+	"void main() {"
+	"\tvec4 color = texture2D(colormap, v_texcoord);"
+	"\tif (color.a < 0.01) discard;"
+	"\tgl_FragColor = vec4(v_shade * color.rgb, color.a);"
+	"}";
+
+	pickup_shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
+	pickup_shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
+	pickup_shader.bindVertexAttrib("position", PU_VA_POSITION);
+	pickup_shader.bindVertexAttrib("normal", PU_VA_NORMAL);
+	pickup_shader.bindVertexAttrib("texcoord", PU_VA_TEXCOORD);
+	pickup_shader.bindVertexAttrib("center", PU_VA_CENTER);
+	pickup_shader.bindVertexAttrib("collect_time", PU_VA_COLLECT_TIME);
+	pickup_shader.link();
+	pickup_shader.use();
+	pickup_program = RenderQueue::getCurrentProgram();
+	pickup_mvp_loc = pickup_shader.getUniformLocation("mvp");
+	pickup_time_loc = pickup_shader.getUniformLocation("time");
+	pickup_anim_loc = pickup_shader.getUniformLocation("anim");
+	pickup_colormap_loc = pickup_shader.getUniformLocation("colormap");
+}
+
+void Pickup::destroyRender() {
+	glDeleteTextures(PT_COUNT, pickup_textures);
+	memset(pickup_textures, 0, sizeof(pickup_textures));
+	pickup_shader.destroy();
+}
+
+size_t PickupBatch::build(Track *track, vec2 origin, float *out) {
+	std::vector<Pickup> &pickups = track->pickups;
+	if (out) pickup_first_vertex.resize(pickups.size());
+
+	// grouped by type
+	size_t float_count = 0;
+	int vertex_index = 0;
+	for (int type = 0; type < PT_COUNT; type++) {
+		StaticMesh &mesh = pickup_meshes[type];
+		first_vertex[type] = vertex_index;
+		for (size_t i = 0; i < pickups.size(); i++) {
+			if (pickups[i].type != type) continue;
+			if (out) {
+				pickup_first_vertex[i] = (u32)vertex_index;
+				vec3 center = pickups[i].position - v3(origin, 0.0f);
+				const float *v = mesh.vertices.data();
+				for (int vi = 0; vi < mesh.vertex_count; vi++) {
+					memcpy(out, v, STATIC_MESH_VERTEX_SIZE * sizeof(float));
+					out[STATIC_MESH_VERTEX_SIZE+0] = center.x;
+					out[STATIC_MESH_VERTEX_SIZE+1] = center.y;
+					out[STATIC_MESH_VERTEX_SIZE+2] = center.z;
+					v += STATIC_MESH_VERTEX_SIZE;
+					out += PICKUP_VERTEX_SIZE;
+				}
+			}
+			vertex_index += mesh.vertex_count;
+			float_count += (size_t)(PICKUP_VERTEX_SIZE * mesh.vertex_count);
+		}
+		vertex_count[type] = vertex_index - first_vertex[type];
+	}
+	return float_count;
+}
+
+void PickupBatch::draw(Track *track, int revision, mat4 mvp, GLuint vbo, size_t vbo_offset, float delta_time) {
+	std::vector<Pickup> &pickups = track->pickups;
+	int total_vertex_count = first_vertex[PT_COUNT-1] + vertex_count[PT_COUNT-1];
+	if (total_vertex_count == 0) return;
+
+	if (state_revision != revision) { // new pickups
+		time = 0.0f;
+		drawn_active.assign(pickups.size(), 1);
+		std::vector<float> collect_times((size_t)total_vertex_count, PICKUP_NOT_COLLECTED);
+		if (!state_vbo) glGenBuffers(1, &state_vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, state_vbo);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(sizeof(float) * collect_times.size()), &collect_times[0], GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		state_revision = revision;
+	}
+	time += delta_time;
+
+	// collected since the last draw
+	bool state_bound = false;
+	for (size_t i = 0; i < pickups.size(); i++) {
+		if (pickups[i].active || !drawn_active[i]) continue;
+		drawn_active[i] = 0;
+		int n = pickup_meshes[pickups[i].type].vertex_count;
+		std::vector<float> collect_times((size_t)n, time - delta_time); // collected during the last tick
+		if (!state_bound) glBindBuffer(GL_ARRAY_BUFFER, state_vbo);
+		state_bound = true;
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(sizeof(float) * pickup_first_vertex[i]),
+			(GLsizeiptr)(sizeof(float) * (size_t)n), &collect_times[0]);
+	}
+	if (state_bound) glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// gas tanks spin and bob and are gone once collected, oil spills shrink away
+	const float anims[PT_COUNT][3] = {{3.0f, 0.25f, 1.0e6f}, {0.0f, 0.0f, 2.0f}};
+	GLsizei stride = PICKUP_VERTEX_SIZE * sizeof(float);
+	for (int type = 0; type < PT_COUNT; type++) {
+		if (vertex_count[type] == 0) continue;
+		RenderCommand *c = render_queue.add(RP_OPAQUE, pickup_program, pickup_textures[type], 0.0f,
+			vertex_count[type], first_vertex[type]);
+		render_queue.setAttrib(c, PU_VA_POSITION, vbo, 3, GL_FLOAT, GL_FALSE, stride, vbo_offset);
+		render_queue.setAttrib(c, PU_VA_NORMAL, vbo, 3, GL_FLOAT, GL_FALSE, stride, vbo_offset + 3*sizeof(float));
+		render_queue.setAttrib(c, PU_VA_TEXCOORD, vbo, 2, GL_FLOAT, GL_FALSE, stride, vbo_offset + 6*sizeof(float));
+		render_queue.setAttrib(c, PU_VA_CENTER, vbo, 3, GL_FLOAT, GL_FALSE, stride, vbo_offset + 8*sizeof(float));
+		render_queue.setAttrib(c, PU_VA_COLLECT_TIME, state_vbo, 1, GL_FLOAT, GL_FALSE, sizeof(float), 0);
+		render_queue.addUniform(c, pickup_mvp_loc, mvp);
+		render_queue.addUniform(c, pickup_time_loc, RU_FLOAT, &time);
+		render_queue.addUniform(c, pickup_anim_loc, RU_VEC3, anims[type]);
+		render_queue.addUniform(c, pickup_colormap_loc, 0);
+	}
+}
+
+void PickupBatch::getMemoryUsage(MemoryReport *report) {
+	size_t vertex_count_total = (size_t)(first_vertex[PT_COUNT-1] + vertex_count[PT_COUNT-1]);
+	report->add(MT_PICKUPS, vectorBytes(pickup_first_vertex) + vectorBytes(drawn_active),
+		state_vbo ? sizeof(float) * vertex_count_total : 0);
+}
+
+void PickupBatch::destroy() {
+	if (state_vbo) glDeleteBuffers(1, &state_vbo);
+	state_vbo = 0;
+	state_revision = -1;
+	drawn_active.clear();
+	pickup_first_vertex.clear();
+}
@@ -0,0 +1,22 @@
+const int PICKUP_VERTEX_SIZE = STATIC_MESH_VERTEX_SIZE + 3; // floats: model vertex, pickup position
+
+// gpu side of a track's pickups, part of TrackMesh
+// every pickup is a copy of its type's model in one buffer, so each type takes one draw call
+// spinning, bobbing and vanishing happen in the vertex shader
+struct PickupBatch {
+	int first_vertex[PT_COUNT] = {}; // in TrackMesh::vbo after the track's vertices
+	int vertex_count[PT_COUNT] = {};
+	std::vector<u32> pickup_first_vertex; // of every pickup in Track::pickups
+
+	// time each pickup was collected, per vertex, updated when Pickup::active changes
+	GLuint state_vbo = 0;
+	int state_revision = -1;
+	std::vector<u8> drawn_active; // Pickup::active as in state_vbo
+	float time = 0.0f; // animation
+
+	// vertex data relative to origin, returns the number of floats written (counts only if out is null)
+	size_t build(Track *track, vec2 origin, float *out); // cpu only
+	void draw(Track *track, int revision, mat4 mvp, GLuint vbo, size_t vbo_offset, float delta_time); // into render_queue
+	void destroy();
+	void getMemoryUsage(MemoryReport *report);
+};
@@ -1,63 +1,18 @@
-MDLModel Player::car_model;
-MDLModel Player::explosion_model;
+// a tap between two ticks is down for the next tick, its edges are only cleared after an update
+static bool isButtonDown(ButtonState *button) {
+	return button->down() || button->pressed() || button->clicked();
+}
 
-float IDLE_FUEL_CONSUMPTION = 1.0f / 60.0f;
-float ACCELERATION_FUEL_CONSUMPTION = 1.0f / 60.0f;
+u8 PlayerControls::getButtons() {
+	u8 buttons = 0;
+	if (isButtonDown(&button_steer_left))  buttons |= PB_STEER_LEFT;
+	if (isButtonDown(&button_steer_right)) buttons |= PB_STEER_RIGHT;
+	if (isButtonDown(&button_accelerate))  buttons |= PB_ACCELERATE;
+	if (isButtonDown(&button_decelerate))  buttons |= PB_DECELERATE;
+	return buttons;
+}
 
 void Player::init() {
-	idle_action = car_model.getActionByName("idle");
-	steer_left_action = car_model.getActionByName("steer_left");
-	steer_right_action = car_model.getActionByName("steer_right");
-
-	// replace explosion shader
-	{
-		const char *vert_source = 
-		"uniform mat4 mvp;"
-		"uniform mat4 bone_mats[16];"
-		"attribute vec3 va_position;"
-		"attribute vec2 va_texcoord0;"
-		"attribute vec4 va_bone_indices;"
-		"attribute vec3 va_bone_weights;"
-		"varying vec3 v_normal;"
-		"varying vec2 v_texcoord0;"
-		"void main() {"
-		"\tv_texcoord0 = va_texcoord0;"
-		"\tivec4 bone_indices = ivec4(va_bone_indices);"
-		"\tfloat bone_weight3 = 1.0 - va_bone_weights[0] - va_bone_weights[1] - va_bone_weights[2];"
-		"\tmat4 bone_mat = va_bone_weights[0] * bone_mats[bone_indices[0]];"
-		"\tbone_mat += va_bone_weights[1] * bone_mats[bone_indices[1]];"
-		"\tbone_mat += va_bone_weights[2] * bone_mats[bone_indices[2]];"
-		"\tbone_mat += bone_weight3 * bone_mats[bone_indices[3]];"
-		"\tgl_Position = mvp*bone_mat*vec4(va_position, 1.0);"
-		"}";
-
-		const char *frag_source =
-		"#ifdef GL_ES\n"
-		"precision mediump float;\n"
-		"#endif\n"
-		"uniform sampler2D colormap;"
-		"varying vec2 v_texcoord0;"
-		"void main() {"
-		"\tvec4 color = texture2D(colormap, v_texcoord0);"
-		"if (color.a < 0.01) discard;"
-		"\tgl_FragColor = vec4(color.rgb, color.a);"
-		"}";
-
-		explosion_model.shader.destroy();
-		explosion_model.shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
-		explosion_model.shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
-		explosion_model.vertex_arrays[0].format.bindShaderAttribs(&explosion_model.shader);
-		explosion_model.shader.link();
-		explosion_model.shader.use();
-		explosion_model.mvp_loc = explosion_model.shader.getUniformLocation("mvp");
-		explosion_model.normal_mat_loc = explosion_model.shader.getUniformLocation("normal_mat");
-		explosion_model.bone_mats_loc = explosion_model.shader.getUniformLocation("bone_mats");
-		explosion_model.colormap_loc = explosion_model.shader.getUniformLocation("colormap");
-		glBindTexture(GL_TEXTURE_2D, explosion_model.textures[0]);
-		setFilterTexture2D(GL_NEAREST, GL_NEAREST);
-	}
-	spin_action = explosion_model.getActionByName("spin");
-
 	reset();
 }
 
@@ -72,6 +27,7 @@ void Player::reset() {
 
 	heading = angleFromDir(v2(0.0f, 1.0f));
 	speed = 0.0f;
+	steering_angle = 0.0f;
 }
 
 void Player::respawn(vec3 p, vec2 dir) {
@@ -83,16 +39,58 @@ void Player::respawn(vec3 p, vec2 dir) {
 	heading = angleFromDir(dir);
 	speed = 0.0f;
 	position = p;
+	skipInterpolation();
+}
+
+void Player::skipInterpolation() {
+	prev_position = position;
+	prev_heading = heading;
+}
+
+void Player::translate(vec2 offset) {
+	position += v3(offset, 0.0f);
+	prev_position += v3(offset, 0.0f);
+	explosion_center += v3(offset, 0.0f);
+	last_position_on_track += offset;
 }
 
-void Player::checkTrack(Track *track) {
+void Player::checkTrack(Track *track, Track *next, Track *prev) {
 	if (!alive) return; // no need to do collision checks
 
-	float z;
+	float z, probe_z;
 	vec2 t = dirFromAngle(heading - 0.5f*(float)M_PI);
-	leftOnTrack = track->traceZ(v2(position)-t, &z);
-	rightOnTrack = track->traceZ(v2(position)+t, &z);
-	centerOnTrack = track->traceZ(v2(position), &z, &distance);
+	// center and both sides in one batch
+	vec2 probes[3] = {v2(position), v2(position)-t, v2(position)+t};
+	float probe_zs[3];
+	bool hits[3];
+	float distances[3] = {distance, distance, distance};
+	cursor.traceZ(track, 3, probes, probe_zs, hits, distances);
+	centerOnTrack = hits[0];
+	leftOnTrack = hits[1];
+	rightOnTrack = hits[2];
+	z = probe_zs[0];
+	distance = distances[0];
+	if (next) { // straddling the seam between chunks
+		TrackCursor next_cursor;
+		next_cursor.index = 0;
+		next_cursor.track = next;
+		next_cursor.revision = next->revision;
+		if (!leftOnTrack) leftOnTrack = next_cursor.traceZ(next, v2(position)-t, &probe_z);
+		if (!rightOnTrack) rightOnTrack = next_cursor.traceZ(next, v2(position)+t, &probe_z);
+		if (!centerOnTrack) {
+			centerOnTrack = next_cursor.traceZ(next, v2(position), &z, &distance);
+			if (centerOnTrack) cursor = next_cursor; // moved on to the next chunk
+		}
+	}
+	if (prev && !prev->segments.empty()) { // just past the seam, or back across it
+		TrackCursor prev_cursor;
+		prev_cursor.index = prev->segments.size() - 1;
+		prev_cursor.track = prev;
+		prev_cursor.revision = prev->revision;
+		if (!leftOnTrack) leftOnTrack = prev_cursor.traceZ(prev, v2(position)-t, &probe_z);
+		if (!rightOnTrack) rightOnTrack = prev_cursor.traceZ(prev, v2(position)+t, &probe_z);
+		if (!centerOnTrack) centerOnTrack = prev_cursor.traceZ(prev, v2(position), &z, &distance);
+	}
 	if (centerOnTrack) {
 		last_position_on_track = v2(position);
 		position.z = z;
@@ -109,6 +107,7 @@ void Player::onGasTank() {
 void Player::onOilSpill() {
 	if (oil_spill > 0.0f) return;
 	oil_spill = OIL_SPILL_DURATION;
+	if (effects) effects->emit(PK_OIL, position, v3(0.5f * speed * dirFromAngle(heading), 0.0f));
 }
 
 void Player::onFellOffTrack() {
@@ -133,21 +132,18 @@ void Player::onExploded() {
 
 	explosion_center = position + v3(0.0f, 0.0f, 1.0f);
 	explosion_time = 0.0f;
+	if (effects) effects->emit(PK_FIRE, explosion_center, v3(0.0f));
 }
 
 void Player::tick(float delta_time) {
-	const float MAX_STEERING_ANGLE = 0.5f/3.0f * (float)M_PI; // 30°
-
 	bool acceleration_disabled = false;
 	bool steering_disabled = false;
 
-	// handle effects
-	spin_action->frame++;
-	spin_action->frame %= spin_action->frame_count-1;
-	explosion_model.applyAction(spin_action);
+	prev_position = position;
+	prev_heading = heading;
 
 	// idle fuel consumption
-	if (!exploded) fuel = fmaxf(0.0f, fuel - delta_time * IDLE_FUEL_CONSUMPTION);
+	if (!exploded) fuel = fmaxf(0.0f, fuel - delta_time * balance->idle_fuel_consumption);
 
 	if (!alive) {
 		if (fell_off_track) {
@@ -190,18 +186,18 @@ void Player::tick(float delta_time) {
 	}
 
 	// controls
-	if (controls.button_accelerate.down()) {
+	if (input.down(PB_ACCELERATE)) {
 		speed += delta_time * acceleration;
-		fuel = fmaxf(0.0f, fuel - delta_time * ACCELERATION_FUEL_CONSUMPTION);
+		fuel = fmaxf(0.0f, fuel - delta_time * balance->acceleration_fuel_consumption);
 	}
-	if (controls.button_decelerate.down()) {
+	if (input.down(PB_DECELERATE)) {
 		float prev_speed = speed;
 		speed -= delta_time * deceleration;
-		if (prev_speed >= 0.0f && speed < 0.0f && !controls.button_decelerate.pressed()) {
+		if (prev_speed >= 0.0f && speed < 0.0f && !input.pressed(PB_DECELERATE)) {
 			speed = 0.0f; // brake to zero, button needs to be pressed again to reverse
 		}
 	}
-	if (!controls.button_accelerate.down() && !controls.button_decelerate.down()) {
+	if (!input.down(PB_ACCELERATE) && !input.down(PB_DECELERATE)) {
 		// apply engine brake
 		float engine_brake_deceleration = 20.0f;
 		if (speed > 0.0f) {
@@ -214,9 +210,9 @@ void Player::tick(float delta_time) {
 		}
 	}
 
-	float steering_angle = 0.0f;
-	if (controls.button_steer_left.down() && !controls.button_steer_right.down()) steering_angle = MAX_STEERING_ANGLE;
-	if (controls.button_steer_right.down() && !controls.button_steer_left.down()) steering_angle = -MAX_STEERING_ANGLE;
+	steering_angle = 0.0f;
+	if (input.down(PB_STEER_LEFT) && !input.down(PB_STEER_RIGHT)) steering_angle = MAX_STEERING_ANGLE;
+	if (input.down(PB_STEER_RIGHT) && !input.down(PB_STEER_LEFT)) steering_angle = -MAX_STEERING_ANGLE;
 
 	// apply drag to speed
 	speed *= 0.998f;
@@ -239,59 +235,4 @@ void Player::tick(float delta_time) {
 
 	// calc new heading
 	heading = angleFromDir(normalize(front_wheel_pos - back_wheel_pos));
-
-
-#ifdef DEBUG
-	ImGui::Begin("car");
-	ImGui::Text("speed: %f m/s", (double)speed);
-	ImGui::Text("speed: %f km/h", (double)speed * 3.6);
-	ImGui::End();
-#endif
-
-	// update animation
-	car_model.applyAction(idle_action);
-	if (steering_angle < 0.0f) car_model.blendAction(steer_right_action, -steering_angle / MAX_STEERING_ANGLE);
-	else if (steering_angle > 0.0f) car_model.blendAction(steer_left_action, steering_angle / MAX_STEERING_ANGLE);
 }
-
-void Player::draw(mat4 view_proj_mat) {
-	float z_angle = heading - 0.5f * (float)M_PI;
-	float y_angle = 0.0f;
-
-	if (oil_spill > 0.0f) {
-		z_angle += 2.0f*(float)M_PI * oil_spill/OIL_SPILL_DURATION;
-	}
-
-	// on the brink off falling off track animation
-	if (!leftOnTrack || !rightOnTrack) {
-		float c = cosf(10.0f*timeHalfOffTrack);
-		if (!leftOnTrack) c = c - 1.0f;
-		else c = 1.0f - c;
-		y_angle = fminf(timeHalfOffTrack, 0.25f)*c;
-	}
-
-	mat4 fell_off_track_mat = m4(1.0f);
-	if (fell_off_track) { // spin car around y axis
-		fell_off_track_mat = translationMatrix(v3(0.0f, 0.0f, 1.0f))
-			*  m4(rotationMatrix(v3(0.0f, 1.0f, 0.0f), off_track_y_angle))
-			* translationMatrix(v3(0.0f, 0.0f, -1.0f));
-	}
-
-	mat4 car_mat = translationMatrix(position)
-		* m4(rotationMatrix(v3(0.0f, 0.0f, 1.0f), z_angle))
-		* m4(rotationMatrix(v3(0.0f, 1.0f, 0.0f), y_angle))
-		* fell_off_track_mat;
-	if (!exploded) {
-		car_model.draw(view_proj_mat * car_mat);
-	}
-
-	if (exploded && explosion_time < EXPLOSION_DURATION) {
-		float s = 2.0f + 4.0f*explosion_time;
-		for (int i = 0; i < 5; i++) {
-			vec3 p = 2.0f * v3(randf(), randf(), randf()) - v3(1.0f);
-			float rot = (float)M_PI * randf();
-			explosion_model.draw(view_proj_mat * translationMatrix(explosion_center + p + v3(0.0f, 0.0f, 1.0f)) * 
-				m4(rotationMatrix(v3(0.0f, 1.0f, 1.0f), rot) * scaleMatrix(v3(s))));
-		}
-	}
-}
\ No newline at end of file
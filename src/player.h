@@ -1,8 +1,28 @@
+enum PlayerButton {
+	PB_STEER_LEFT  = 1 << 0,
+	PB_STEER_RIGHT = 1 << 1,
+	PB_ACCELERATE  = 1 << 2,
+	PB_DECELERATE  = 1 << 3
+};
+
 struct PlayerControls {
 	ButtonState button_steer_left;
 	ButtonState button_steer_right;
 	ButtonState button_accelerate;
 	ButtonState button_decelerate;
+
+	u8 getButtons(); // PlayerButton bits of the buttons held down or tapped since the last tick
+};
+
+// buttons of a single tick, sampled from PlayerControls or read from a replay
+struct PlayerInput {
+	u8 buttons = 0;
+	u8 prev_buttons = 0; // buttons of the previous tick
+
+	void update(u8 new_buttons) { prev_buttons = buttons; buttons = new_buttons; }
+	bool down(u8 button) { return (buttons & button) != 0; }
+	bool pressed(u8 button) { return (buttons & button) != 0 && (prev_buttons & button) == 0; }
+	bool released(u8 button) { return (buttons & button) == 0 && (prev_buttons & button) != 0; }
 };
 
 /*
@@ -16,11 +36,13 @@ enum PlayerState {
 const float OIL_SPILL_DURATION = 0.5f;
 const float EXPLOSION_DURATION = 1.0f;
 const float HALF_OFF_TRACK_DURATION = 1.0f;
+const float MAX_STEERING_ANGLE = 0.5f/3.0f * (float)M_PI; // 30°
 
 class Track;
 
 struct Player {
 	PlayerControls controls;
+	PlayerInput input; // what tick reacts to
 
 	//PlayerState state;
 	bool alive;
@@ -29,21 +51,22 @@ struct Player {
 
 	float fuel;
 	float distance; // distance in meters traveled on track
+	const GameBalance *balance = &default_balance; // fuel consumption
 
 	vec3 position;
 	float speed;
 	float heading;
+	float steering_angle; // output of tick, used to pose the car model
 
-	static MDLModel car_model;
-	MDLAction *idle_action;
-	MDLAction *steer_left_action;
-	MDLAction *steer_right_action;
-	static MDLModel explosion_model;
-	MDLAction *spin_action;
+	// state before the last tick, drawing interpolates between this and the current state
+	vec3 prev_position;
+	float prev_heading;
+	void skipInterpolation(); // call after placing the player somewhere new
 
 	void init();
 	void reset();
 	void respawn(vec3 p, vec2 dir);
+	void translate(vec2 offset); // moves all positions along with the world
 
 	void onExploded();
 	void onFellOffTrack();
@@ -65,13 +88,21 @@ struct Player {
 	vec3 explosion_center;
 	// /explosion state
 
+	ParticleSystem *effects = nullptr; // explosions and oil splashes go here if set
+
 	bool centerOnTrack;
 	bool leftOnTrack;
 	bool rightOnTrack;
 	vec2 last_position_on_track;
+	TrackCursor cursor; // where on the track the player is, shared by all track queries
 	float timeHalfOffTrack = 0.0f; // if this reaches HALF_OFF_TRACK_DURATION -> fall off track
-	void checkTrack(Track *track); // updates the *OnTrack flags
+	// updates the *OnTrack flags, next continues track and prev is the chunk before it (endless mode)
+	void checkTrack(Track *track, Track *next = nullptr, Track *prev = nullptr);
 
 	void tick(float delta_time);
-	void draw(mat4 view_proj);
+
+	// render side (player_render.cpp), not available in headless builds
+	static void initRender();
+	static void destroyRender();
+	void draw(mat4 view_proj, float alpha);
 };
\ No newline at end of file
@@ -0,0 +1,74 @@
+static MDLModel car_model;
+static MDLAction *idle_action;
+static MDLAction *steer_left_action;
+static MDLAction *steer_right_action;
+
+// car_model keeps the pose it was given last, so it's only posed again when the steering step changes
+const int CAR_POSE_STEPS = 16; // steering blends per side
+const float CAR_RADIUS = 3.0f; // bounding sphere around the car's center, for culling
+static int car_pose_step = -1; // of the pose in car_model, in [0, 2*CAR_POSE_STEPS]
+
+void Player::initRender() {
+	car_model.load("data/models/car.mdl");
+	trackModel(&car_model, "data/models/car.mdl");
+
+	idle_action = car_model.getActionByName("idle");
+	steer_left_action = car_model.getActionByName("steer_left");
+	steer_right_action = car_model.getActionByName("steer_right");
+	car_pose_step = -1;
+}
+
+void Player::destroyRender() {
+	car_model.destroy();
+}
+
+void Player::draw(mat4 view_proj_mat, float alpha) {
+	vec3 draw_position = mix(prev_position, position, alpha);
+	float z_angle = mixAngles(prev_heading, heading, alpha) - 0.5f * (float)M_PI;
+	float y_angle = 0.0f;
+
+	if (oil_spill > 0.0f) {
+		z_angle += 2.0f*(float)M_PI * oil_spill/OIL_SPILL_DURATION;
+	}
+
+	// on the brink off falling off track animation
+	if (!leftOnTrack || !rightOnTrack) {
+		float c = cosf(10.0f*timeHalfOffTrack);
+		if (!leftOnTrack) c = c - 1.0f;
+		else c = 1.0f - c;
+		y_angle = fminf(timeHalfOffTrack, 0.25f)*c;
+	}
+
+	mat4 fell_off_track_mat = m4(1.0f);
+	if (fell_off_track) { // spin car around y axis
+		fell_off_track_mat = translationMatrix(v3(0.0f, 0.0f, 1.0f))
+			*  m4(rotationMatrix(v3(0.0f, 1.0f, 0.0f), off_track_y_angle))
+			* translationMatrix(v3(0.0f, 0.0f, -1.0f));
+	}
+
+	mat4 car_mat = translationMatrix(draw_position)
+		* m4(rotationMatrix(v3(0.0f, 0.0f, 1.0f), z_angle))
+		* m4(rotationMatrix(v3(0.0f, 1.0f, 0.0f), y_angle))
+		* fell_off_track_mat;
+	if (exploded) return;
+
+	// neither posed nor drawn when off screen, e.g. falling down the abyss
+	vec4 planes[6];
+	getCullingPlanes(view_proj_mat, planes);
+	vec3 center = draw_position + v3(0.0f, 0.0f, 1.0f);
+	for (int i = 0; i < 6; i++) {
+		vec3 n = v3(planes[i].x, planes[i].y, planes[i].z); // not normalized
+		if (dot(n, center) + planes[i].w < -CAR_RADIUS * length(n)) return;
+	}
+
+	float steering = fminf(1.0f, fmaxf(-1.0f, steering_angle / MAX_STEERING_ANGLE));
+	int pose_step = CAR_POSE_STEPS + (int)roundf(steering * (float)CAR_POSE_STEPS);
+	if (pose_step != car_pose_step) {
+		car_pose_step = pose_step;
+		float weight = (float)(pose_step - CAR_POSE_STEPS) / (float)CAR_POSE_STEPS;
+		car_model.applyAction(idle_action);
+		if (weight < 0.0f) car_model.blendAction(steer_right_action, -weight);
+		else if (weight > 0.0f) car_model.blendAction(steer_left_action, weight);
+	}
+	render_queue.addModel(&car_model, view_proj_mat * car_mat, getViewDepth(view_proj_mat, center));
+}
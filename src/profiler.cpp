@@ -0,0 +1,73 @@
+Profiler profiler;
+
+static thread_local ProfileThread *profile_thread = nullptr; // never freed, threads may outlive the profiler
+
+void Profiler::init() {
+	start_time = std::chrono::steady_clock::now();
+	enabled = false;
+}
+
+u64 Profiler::now() {
+	return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+ProfileThread *Profiler::getThread() {
+	if (!profile_thread) {
+		profile_thread = new ProfileThread();
+		std::lock_guard<std::mutex> lock(threads_mutex);
+		profile_thread->id = (int)threads.size();
+		threads.push_back(profile_thread);
+	}
+	return profile_thread;
+}
+
+void Profiler::setThreadName(const char *name) {
+	getThread()->name = name;
+}
+
+void ProfileScope::end() {
+	if (!thread) return;
+	ProfileEvent event = {name, begin, profiler.now(), depth};
+	thread->depth--;
+	{
+		std::lock_guard<std::mutex> lock(thread->mutex);
+		thread->events[thread->event_count % PROFILER_RING_SIZE] = event;
+		thread->event_count++;
+	}
+	thread = nullptr;
+}
+
+void Profiler::beginFrame() {
+	frame_thread = getThread();
+	u64 t = now();
+	last_frame_begin = frame_begin;
+	last_frame_end = t;
+	frame_begin = t;
+}
+
+// complete events ("ph":"X") in microseconds, see the trace event format
+bool Profiler::writeTrace(const char *filename) {
+	FILE *file = fopen(filename, "w");
+	if (!file) {
+		LOGE("Could not write profiler trace: %s", filename);
+		return false;
+	}
+	fprintf(file, "{\"traceEvents\":[\n");
+	bool first = true;
+	std::lock_guard<std::mutex> lock(threads_mutex);
+	for (ProfileThread *thread : threads) {
+		std::lock_guard<std::mutex> thread_lock(thread->mutex);
+		fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+			first ? "" : ",\n", thread->id, thread->name);
+		first = false;
+		u64 count = thread->event_count < PROFILER_RING_SIZE ? thread->event_count : PROFILER_RING_SIZE;
+		for (u64 i = thread->event_count - count; i < thread->event_count; i++) {
+			ProfileEvent &e = thread->events[i % PROFILER_RING_SIZE];
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				e.name, thread->id, 1.0e-3 * (double)e.begin, 1.0e-3 * (double)(e.end - e.begin));
+		}
+	}
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,67 @@
+/*
+scoped cpu timers, e.g. PROFILE_SCOPE("Player::tick");
+every thread records finished scopes into its own ring buffer, the last
+PROFILER_RING_SIZE of them can be shown with ImGui or written as a chrome
+trace (chrome://tracing, ui.perfetto.dev)
+when disabled a scope only checks a flag, so they stay in release builds
+*/
+
+const int PROFILER_RING_SIZE = 4096; // events per thread
+
+struct ProfileEvent {
+	const char *name; // string literal
+	u64 begin, end; // ns since Profiler::init
+	int depth; // number of enclosing scopes
+};
+
+struct ProfileThread {
+	int id;
+	const char *name = "thread";
+	std::mutex mutex; // the owner writes, anyone may read
+	ProfileEvent events[PROFILER_RING_SIZE];
+	u64 event_count = 0; // ever recorded
+	int depth = 0; // open scopes, only touched by the owner
+};
+
+struct Profiler {
+	std::atomic<bool> enabled;
+	std::chrono::steady_clock::time_point start_time;
+	std::mutex threads_mutex;
+	std::vector<ProfileThread*> threads;
+
+	// main thread frames, for drawInfo
+	ProfileThread *frame_thread = nullptr;
+	u64 frame_begin = 0;
+	u64 last_frame_begin = 0, last_frame_end = 0;
+
+	void init();
+	u64 now();
+	ProfileThread *getThread(); // of the calling thread, registered on first use
+	void setThreadName(const char *name);
+	void beginFrame();
+	bool writeTrace(const char *filename);
+	void drawInfo(); // DEBUG ImGui
+};
+
+extern Profiler profiler;
+
+struct ProfileScope {
+	ProfileThread *thread; // null when the profiler was disabled at the start of the scope
+	const char *name;
+	u64 begin;
+	int depth;
+
+	explicit ProfileScope(const char *scope_name) : thread(nullptr) {
+		if (!profiler.enabled.load(std::memory_order_relaxed)) return;
+		thread = profiler.getThread();
+		name = scope_name;
+		depth = thread->depth++;
+		begin = profiler.now();
+	}
+	~ProfileScope() { end(); }
+	void end(); // before the end of the scope
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profile_scope_, __LINE__)(name)
@@ -0,0 +1,50 @@
+/*
+small seedable random number generator (pcg32)
+unlike gamelib's global randf() every system owns its stream, so e.g.
+a track only depends on its own seed and can be generated on any thread
+*/
+
+// mixes a value into a seed (splitmix64), e.g. to derive the seed of a level
+inline u64 hashSeed(u64 seed, u64 value) {
+	u64 z = seed + 0x9E3779B97F4A7C15ULL * (value + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+// pcg stream selectors, streams with the same seed but different ids are independent
+enum RandomStreamId {
+	STREAM_TRACK, // track generation, level seeds
+	STREAM_PARTICLES, // effects, per run
+};
+
+struct RandomStream {
+	u64 state;
+	u64 inc; // selects the stream, always odd
+
+	RandomStream(u64 seed = 0, u64 stream = 0) { this->seed(seed, stream); }
+
+	void seed(u64 seed, u64 stream = 0) {
+		state = 0;
+		inc = (stream << 1) | 1;
+		next();
+		state += seed;
+		next();
+	}
+
+	u32 next() {
+		u64 old_state = state;
+		state = old_state * 6364136223846793005ULL + inc;
+		u32 xorshifted = (u32)(((old_state >> 18) ^ old_state) >> 27);
+		u32 rot = (u32)(old_state >> 59);
+		return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+	}
+
+	float nextf() { // [0, 1)
+		return (float)(next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	float rangef(float min, float max) {
+		return min + nextf() * (max - min);
+	}
+};
@@ -0,0 +1,225 @@
+RenderQueue render_queue;
+
+static const int uniform_float_counts[] = {1, 1, 2, 3, 4, 16}; // per RenderUniformType
+
+const float RENDER_DEPTH_SCALE = 64.0f; // 1/64 m steps in the keys, up to 1024 m
+
+u64 RenderQueue::makeKey(RenderPass pass, GLuint program, GLuint texture, float depth) {
+	u64 d = (u64)(fminf(fmaxf(depth, 0.0f), 1023.0f) * RENDER_DEPTH_SCALE); // 16 bits
+	u64 p = (u64)(program & 0xff);
+	u64 t = (u64)(texture & 0xffff);
+	if (pass == RP_TRANSPARENT) { // blending needs the order more than the state
+		return (u64)pass << 62 | (0xffff - d) << 46 | p << 38 | t << 22;
+	}
+	return (u64)pass << 62 | p << 54 | t << 38 | d << 22;
+}
+
+RenderCommand *RenderQueue::add(RenderPass pass, GLuint program, GLuint texture, float depth, GLsizei count, GLint first) {
+	commands.push_back(RenderCommand());
+	RenderCommand *command = &commands.back();
+	command->key = makeKey(pass, program, texture, depth);
+	command->program = program;
+	command->texture = texture;
+	command->first = first;
+	command->count = count;
+	command->depth_write = pass != RP_TRANSPARENT;
+	return command;
+}
+
+void RenderQueue::addModel(MDLModel *model, mat4 mvp, float depth) {
+	commands.push_back(RenderCommand());
+	RenderCommand &command = commands.back();
+	command.key = makeKey(RP_OPAQUE, 0, 0, depth); // all of them together
+	command.model = model;
+	command.model_mvp = mvp;
+}
+
+void RenderQueue::setAttrib(RenderCommand *command, int location, GLuint buffer, GLint size, GLenum type,
+	GLboolean normalized, GLsizei stride, size_t offset) {
+	assert(location >= 0 && location < RENDER_MAX_ATTRIBS);
+	RenderAttrib &attrib = command->attribs[location];
+	attrib.buffer = buffer;
+	attrib.size = size;
+	attrib.type = type;
+	attrib.normalized = normalized;
+	attrib.stride = stride;
+	attrib.offset = offset;
+}
+
+void RenderQueue::addUniform(RenderCommand *command, GLint location, RenderUniformType type, const float *values) {
+	assert(command->uniform_count < RENDER_MAX_UNIFORMS);
+	RenderUniform &uniform = command->uniforms[command->uniform_count++];
+	uniform.location = location;
+	uniform.type = type;
+	uniform.offset = (u32)uniform_data.size();
+	uniform_data.insert(uniform_data.end(), values, values + uniform_float_counts[type]);
+}
+
+void RenderQueue::addUniform(RenderCommand *command, GLint location, int value) {
+	float f = (float)value;
+	addUniform(command, location, RU_INT, &f);
+}
+
+GLuint RenderQueue::getCurrentProgram() {
+	GLint program = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+	return (GLuint)program;
+}
+
+void RenderQueue::forgetUniforms() {
+	_uniform_cache.clear();
+}
+
+// everybody unbinds their buffers, disables their attributes and writes depth again after drawing
+// assuming that never skips a bind that is needed, a draw never uses buffer 0
+void RenderQueue::forgetState() {
+	_state.program = RENDER_UNKNOWN;
+	_state.texture = RENDER_UNKNOWN;
+	_state.array_buffer = 0;
+	_state.index_buffer = 0;
+	_state.depth_write = GL_TRUE;
+	_state.enabled_attribs = 0;
+	for (RenderAttrib &attrib : _state.attribs) attrib.buffer = 0;
+}
+
+void RenderQueue::resetState() {
+	for (int i = 0; i < RENDER_MAX_ATTRIBS; i++) {
+		if (_state.enabled_attribs & (1u << i)) glDisableVertexAttribArray((GLuint)i);
+	}
+	_state.enabled_attribs = 0;
+	bindArrayBuffer(0);
+	bindIndexBuffer(0);
+	setDepthWrite(true);
+}
+
+void RenderQueue::bindProgram(GLuint program) {
+	if (program == _state.program) {
+		stats.skipped_binds++;
+		return;
+	}
+	glUseProgram(program);
+	_state.program = program;
+}
+
+void RenderQueue::bindTexture(GLuint texture) {
+	if (texture == _state.texture) {
+		stats.skipped_binds++;
+		return;
+	}
+	if (_state.texture == RENDER_UNKNOWN) glActiveTexture(GL_TEXTURE0); // others might have used another unit
+	glBindTexture(GL_TEXTURE_2D, texture);
+	_state.texture = texture;
+}
+
+void RenderQueue::bindArrayBuffer(GLuint buffer) {
+	if (buffer == _state.array_buffer) return; // only a means to set up attributes, not counted
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	_state.array_buffer = buffer;
+}
+
+void RenderQueue::bindIndexBuffer(GLuint index_buffer) {
+	if (index_buffer == _state.index_buffer) {
+		stats.skipped_binds++;
+		return;
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+	_state.index_buffer = index_buffer;
+}
+
+void RenderQueue::setDepthWrite(bool depth_write) {
+	GLuint value = depth_write ? GL_TRUE : GL_FALSE;
+	if (value == _state.depth_write) return;
+	glDepthMask((GLboolean)value);
+	_state.depth_write = value;
+}
+
+void RenderQueue::setAttribs(const RenderAttrib *attribs) {
+	for (int i = 0; i < RENDER_MAX_ATTRIBS; i++) {
+		const RenderAttrib &a = attribs[i];
+		RenderAttrib &current = _state.attribs[i];
+		u32 bit = 1u << i;
+		if (!a.buffer) {
+			if (_state.enabled_attribs & bit) glDisableVertexAttribArray((GLuint)i);
+			_state.enabled_attribs &= ~bit;
+			continue;
+		}
+		if (!(_state.enabled_attribs & bit)) glEnableVertexAttribArray((GLuint)i);
+		_state.enabled_attribs |= bit;
+		if (a.buffer == current.buffer && a.size == current.size && a.type == current.type &&
+			a.normalized == current.normalized && a.stride == current.stride && a.offset == current.offset) {
+			stats.skipped_binds++;
+			continue;
+		}
+		bindArrayBuffer(a.buffer);
+		glVertexAttribPointer((GLuint)i, a.size, a.type, a.normalized, a.stride, (GLvoid*)a.offset);
+		current = a;
+	}
+}
+
+void RenderQueue::uploadUniform(GLuint program, const RenderUniform &uniform) {
+	const float *v = &uniform_data[uniform.offset];
+	int n = uniform_float_counts[uniform.type];
+	UniformValue *cached = nullptr;
+	for (UniformValue &u : _uniform_cache) {
+		if (u.program == program && u.location == uniform.location) {
+			cached = &u;
+			break;
+		}
+	}
+	if (cached && memcmp(cached->values, v, sizeof(float) * (size_t)n) == 0) {
+		stats.skipped_uniforms++;
+		return;
+	}
+	if (!cached) {
+		_uniform_cache.push_back(UniformValue());
+		cached = &_uniform_cache.back();
+		cached->program = program;
+		cached->location = uniform.location;
+	}
+	memcpy(cached->values, v, sizeof(float) * (size_t)n);
+
+	switch (uniform.type) {
+		case RU_INT: glUniform1i(uniform.location, (GLint)v[0]); break;
+		case RU_FLOAT: glUniform1f(uniform.location, v[0]); break;
+		case RU_VEC2: glUniform2f(uniform.location, v[0], v[1]); break;
+		case RU_VEC3: glUniform3f(uniform.location, v[0], v[1], v[2]); break;
+		case RU_VEC4: glUniform4f(uniform.location, v[0], v[1], v[2], v[3]); break;
+		case RU_MAT4: glUniformMatrix4fv(uniform.location, 1, GL_FALSE, v); break;
+	}
+}
+
+void RenderQueue::submit() {
+	PROFILE_SCOPE("RenderQueue::submit");
+	stats = RenderQueueStats();
+	stats.commands = (u32)commands.size();
+
+	_order.resize(commands.size());
+	for (size_t i = 0; i < commands.size(); i++) _order[i] = (u32)i;
+	std::stable_sort(_order.begin(), _order.end(), [this](u32 a, u32 b) { return commands[a].key < commands[b].key; });
+
+	forgetState();
+	for (u32 i : _order) {
+		RenderCommand &c = commands[i];
+		if (c.model) {
+			resetState();
+			c.model->draw(c.model_mvp);
+			forgetState();
+			continue;
+		}
+		bindProgram(c.program);
+		for (int u = 0; u < c.uniform_count; u++) uploadUniform(c.program, c.uniforms[u]);
+		if (c.texture) bindTexture(c.texture);
+		setDepthWrite(c.depth_write);
+		setAttribs(c.attribs);
+		if (c.index_buffer) {
+			bindIndexBuffer(c.index_buffer);
+			glDrawElements(GL_TRIANGLES, c.count, GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(u16) * (size_t)c.first));
+		} else {
+			glDrawArrays(GL_TRIANGLES, c.first, c.count);
+		}
+	}
+	resetState();
+
+	commands.clear();
+	uniform_data.clear();
+}
@@ -0,0 +1,126 @@
+/*
+render queue: the 3d draws of a frame are recorded as commands and submitted sorted by
+pass, shader, texture and depth, so every material's state is set up once per frame
+the backend remembers what is bound and skips binds, attribute setups and uniform uploads
+that wouldn't change anything, uniform values are remembered per program across frames
+gamelib models draw themselves, the backend forgets its state after them
+*/
+
+enum RenderPass {
+	RP_OPAQUE, // front to back
+	RP_TRANSPARENT, // after everything opaque, back to front, no depth writes
+	RP_COUNT
+};
+
+const int RENDER_MAX_ATTRIBS = 8; // attribute locations 0 to 7
+const int RENDER_MAX_UNIFORMS = 4; // per command
+
+// how an attribute location is fed from a vertex buffer
+struct RenderAttrib {
+	GLuint buffer = 0; // 0: attribute not used
+	GLint size = 0;
+	GLenum type = GL_FLOAT;
+	GLboolean normalized = GL_FALSE;
+	GLsizei stride = 0;
+	size_t offset = 0; // in the buffer
+};
+
+enum RenderUniformType {
+	RU_INT, // samplers
+	RU_FLOAT,
+	RU_VEC2,
+	RU_VEC3,
+	RU_VEC4,
+	RU_MAT4
+};
+
+struct RenderUniform {
+	GLint location;
+	RenderUniformType type;
+	u32 offset; // of its floats in RenderQueue::uniform_data
+};
+
+struct RenderCommand {
+	u64 key; // see makeKey
+	MDLModel *model; // drawn by gamelib with model_mvp instead of everything below if set
+	GLuint program;
+	GLuint texture; // on unit 0
+	GLuint index_buffer; // glDrawElements with u16 indices if set, glDrawArrays otherwise
+	GLint first; // vertex or index
+	GLsizei count;
+	bool depth_write;
+	int uniform_count;
+	RenderUniform uniforms[RENDER_MAX_UNIFORMS];
+	RenderAttrib attribs[RENDER_MAX_ATTRIBS];
+	mat4 model_mvp;
+};
+
+const GLuint RENDER_UNKNOWN = 0xffffffff; // program or texture not known
+
+// what the backend last set, so it can skip setting it again
+struct RenderState {
+	GLuint program;
+	GLuint texture;
+	GLuint array_buffer;
+	GLuint index_buffer;
+	GLuint depth_write; // GL_TRUE or GL_FALSE
+	u32 enabled_attribs; // bit per location
+	RenderAttrib attribs[RENDER_MAX_ATTRIBS]; // pointer setups, buffer 0: unknown
+};
+
+// distance along the view direction, for the sort keys
+inline float getViewDepth(mat4 view_proj, vec3 p) {
+	return view_proj.e[3]*p.x + view_proj.e[7]*p.y + view_proj.e[11]*p.z + view_proj.e[15];
+}
+
+struct RenderQueueStats {
+	u32 commands = 0;
+	u32 skipped_binds = 0; // programs, textures, buffers and attribute setups
+	u32 skipped_uniforms = 0;
+};
+
+class RenderQueue {
+public:
+	std::vector<RenderCommand> commands; // of the current frame
+	std::vector<float> uniform_data; // of the current frame's commands
+	RenderQueueStats stats; // of the last submit
+
+	// depth: distance along the view direction in meters, used for sorting only
+	static u64 makeKey(RenderPass pass, GLuint program, GLuint texture, float depth);
+
+	// a draw with nothing but its key and draw range, set the rest and add uniforms before the next one
+	RenderCommand *add(RenderPass pass, GLuint program, GLuint texture, float depth, GLsizei count, GLint first = 0);
+	void addModel(MDLModel *model, mat4 mvp, float depth);
+	void setAttrib(RenderCommand *command, int location, GLuint buffer, GLint size, GLenum type, GLboolean normalized,
+		GLsizei stride, size_t offset);
+	void addUniform(RenderCommand *command, GLint location, RenderUniformType type, const float *values);
+	void addUniform(RenderCommand *command, GLint location, int value);
+	void addUniform(RenderCommand *command, GLint location, mat4 value) { addUniform(command, location, RU_MAT4, value.e); }
+
+	void submit(); // sorted, clears the commands
+	void forgetUniforms(); // after programs were destroyed
+
+	static GLuint getCurrentProgram(); // the one Shader::use just bound, for RenderCommand::program
+
+private:
+	struct UniformValue {
+		GLuint program;
+		GLint location;
+		float values[16];
+	};
+	std::vector<UniformValue> _uniform_cache; // last value uploaded to each program's uniform
+	std::vector<u32> _order; // of the commands, by key
+	RenderState _state;
+
+	void bindProgram(GLuint program);
+	void bindTexture(GLuint texture);
+	void bindArrayBuffer(GLuint buffer);
+	void bindIndexBuffer(GLuint index_buffer);
+	void setDepthWrite(bool depth_write);
+	void setAttribs(const RenderAttrib *attribs);
+	void uploadUniform(GLuint program, const RenderUniform &uniform);
+	void forgetState(); // after someone else drew
+	void resetState(); // unbinds buffers and disables attributes, like the draw code outside the queue expects
+};
+
+extern RenderQueue render_queue;
@@ -0,0 +1,114 @@
+static void writeVarint(FILE *file, u64 value) {
+	while (value >= 0x80) {
+		fputc((int)(value & 0x7F) | 0x80, file);
+		value >>= 7;
+	}
+	fputc((int)value, file);
+}
+
+static bool readVarint(FILE *file, u64 *value) {
+	*value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int c = fgetc(file);
+		if (c == EOF) return false;
+		*value |= (u64)(c & 0x7F) << shift;
+		if (!(c & 0x80)) return true;
+	}
+	return false; // malformed
+}
+
+bool ReplayWriter::open(const char *filename, u32 seed, u8 mode) {
+	file = fopen(filename, "wb");
+	if (!file) {
+		LOGE("Could not open replay file for writing: %s", filename);
+		return false;
+	}
+	fwrite("LDRP", 1, 4, file);
+	fputc(REPLAY_VERSION, file);
+	writeVarint(file, seed);
+	fputc(mode, file);
+
+	tick = 0;
+	last_event_tick = 0;
+	last_buttons = 0;
+	return true;
+}
+
+void ReplayWriter::record(u8 buttons) {
+	if (tick == 0 || buttons != last_buttons) {
+		writeVarint(file, (u64)(tick - last_event_tick) << REPLAY_FLAG_BITS | buttons);
+		last_event_tick = tick;
+		last_buttons = buttons;
+	}
+	tick++;
+}
+
+void ReplayWriter::close() {
+	if (!file) return;
+	writeVarint(file, (u64)(tick - last_event_tick) << REPLAY_FLAG_BITS | REPLAY_END_FLAG);
+	fclose(file);
+	file = nullptr;
+}
+
+bool ReplayReader::open(const char *filename) {
+	file = fopen(filename, "rb");
+	if (!file) {
+		LOGE("Could not open replay file: %s", filename);
+		return false;
+	}
+	char magic[4];
+	u64 seed64;
+	int version = -1;
+	int mode_byte = 0; // version 1 only knew levels
+	if (fread(magic, 1, 4, file) == 4 && memcmp(magic, "LDRP", 4) == 0) version = fgetc(file);
+	if (version < 1 || version > REPLAY_VERSION || !readVarint(file, &seed64) ||
+		(version >= 2 && (mode_byte = fgetc(file)) == EOF))
+	{
+		LOGE("Not a replay file: %s", filename);
+		close();
+		return false;
+	}
+	seed = (u32)seed64;
+	mode = (u8)mode_byte;
+
+	tick = 0;
+	buttons = 0;
+	finished = false;
+	next_tick = 0;
+	readEvent();
+	return true;
+}
+
+void ReplayReader::readEvent() {
+	u64 value;
+	if (!readVarint(file, &value)) {
+		// truncated, e.g. the recording game crashed
+		next_is_end = true;
+		next_tick = tick;
+		return;
+	}
+	next_tick += (u32)(value >> REPLAY_FLAG_BITS);
+	next_buttons = (u8)(value & 0xF);
+	next_is_end = (value & REPLAY_END_FLAG) != 0;
+}
+
+bool ReplayReader::play(u8 *out_buttons) {
+	while (!finished && tick == next_tick) {
+		if (next_is_end) {
+			finished = true;
+			break;
+		}
+		buttons = next_buttons;
+		readEvent();
+	}
+	if (finished) return false;
+
+	*out_buttons = buttons;
+	tick++;
+	return true;
+}
+
+void ReplayReader::close() {
+	if (file) fclose(file);
+	file = nullptr;
+}
@@ -0,0 +1,44 @@
+/*
+replay file format:
+header: "LDRP", u8 version, varint seed, u8 game mode (since version 2)
+events: varint (tick_delta << 5 | flags)
+	flags 0-3: PlayerButton bits held from that tick on
+	flag 4: end of replay, tick_delta is the number of ticks to the end
+events are only written when the buttons change
+*/
+
+const u8 REPLAY_VERSION = 2;
+const u32 REPLAY_END_FLAG = 1 << 4;
+const int REPLAY_FLAG_BITS = 5;
+
+struct ReplayWriter {
+	FILE *file = nullptr;
+	u32 tick = 0; // number of ticks recorded
+	u32 last_event_tick = 0;
+	u8 last_buttons = 0;
+
+	bool open(const char *filename, u32 seed, u8 mode);
+	void record(u8 buttons); // once per tick
+	void close();
+};
+
+struct ReplayReader {
+	FILE *file = nullptr;
+	u32 seed = 0;
+	u8 mode = 0; // GameMode
+	u32 tick = 0; // number of ticks played
+	u8 buttons = 0;
+	bool finished = false;
+
+	// next event
+	u32 next_tick = 0;
+	u8 next_buttons = 0;
+	bool next_is_end = false;
+
+	bool open(const char *filename);
+	bool play(u8 *buttons); // once per tick, false when the replay is over
+	void close();
+
+private:
+	void readEvent();
+};
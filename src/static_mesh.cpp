@@ -0,0 +1,140 @@
+// little endian, like the files written by model_mdl.py
+static u32 readU32(const u8 *p) {
+	u32 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static float readF32(const u8 *p) {
+	float v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+struct StaticMeshNode {
+	u32 mesh_index;
+	vec3 location;
+	float rotation[4]; // quaternion x, y, z, w
+	vec3 scale;
+};
+
+static vec3 rotateByQuat(const float *q, vec3 v) {
+	vec3 u = v3(q[0], q[1], q[2]);
+	vec3 t = 2.0f * cross(u, v);
+	return v + q[3] * t + cross(u, t);
+}
+
+bool StaticMesh::load(const char *filename) {
+	vertices.clear();
+	vertex_count = 0;
+	material[0] = '\0';
+
+	AssetData asset; // parsed in place
+	if (!asset.load(filename)) {
+		LOGE("Could not open model: %s", filename);
+		return false;
+	}
+	const u8 *data = asset.data;
+	if (asset.size <= 16 || memcmp(data, "MDL1", 4) != 0) {
+		LOGE("Not a model file: %s", filename);
+		return false;
+	}
+
+	const u8 *end = data + asset.size;
+	const u8 *p = data + 16; // magic, version, file size, chunk count
+	u32 chunk_count = readU32(data + 12);
+
+	std::vector<StaticMeshNode> nodes;
+	const u8 *vertex_array = nullptr; // the first one
+	u32 attrib_offsets[8];
+	u32 attrib_counts[8];
+	u32 vertex_size = 0;
+	u32 array_vertex_count = 0;
+
+	for (u32 ci = 0; ci < chunk_count && p + 12 <= end; ci++) {
+		const u8 *chunk = p;
+		u32 chunk_size = readU32(chunk + 4);
+		u32 count = readU32(chunk + 8);
+		p = chunk + 12;
+
+		if (memcmp(chunk, "INF1", 4) == 0) {
+			for (u32 i = 0; i < count && p + 68 <= end; i++, p += 68) { // 1I10f6f
+				StaticMeshNode node;
+				node.mesh_index = readU32(p);
+				node.location = v3(readF32(p+4), readF32(p+8), readF32(p+12));
+				for (int k = 0; k < 4; k++) node.rotation[k] = readF32(p + 16 + 4*k);
+				node.scale = v3(readF32(p+32), readF32(p+36), readF32(p+40));
+				nodes.push_back(node);
+			}
+		} else if (memcmp(chunk, "MAT1", 4) == 0 && count > 0 && p + 64 <= end) {
+			memcpy(material, p, 63); // 63sx
+			material[63] = '\0';
+		} else if (memcmp(chunk, "VTX1", 4) == 0 && count > 0) {
+			// (component count, data type) for each VertexAttribType, in the order they are stored
+			const u32 type_sizes[4] = {4, 1, 2, 4};
+			for (int a = 0; a < 8; a++) {
+				attrib_offsets[a] = vertex_size;
+				attrib_counts[a] = p[2*a];
+				vertex_size += p[2*a] * type_sizes[p[2*a+1] & 3];
+			}
+			array_vertex_count = readU32(p + 16);
+			vertex_array = p + 20;
+			if (vertex_array + vertex_size * array_vertex_count > end) vertex_array = nullptr;
+		} else if (memcmp(chunk, "TRI1", 4) == 0) {
+			// the last chunk, its size field doesn't include the index count
+			if (!vertex_array || attrib_counts[0] != 3 || attrib_counts[1] != 3) break;
+			const u8 *meshes = p;
+			const u8 *batches_end = meshes;
+			for (u32 mi = 0; mi < count; mi++) batches_end += 12 + 12 * readU32(batches_end + 8);
+			if (batches_end + 4 > end) break;
+			u32 index_count = readU32(batches_end);
+			const u8 *indices = batches_end + 4;
+			if (indices + 2 * index_count > end) break;
+
+			if (nodes.empty()) { // no scene graph, just the meshes
+				StaticMeshNode node = {0, v3(0.0f), {0.0f, 0.0f, 0.0f, 1.0f}, v3(1.0f)};
+				nodes.push_back(node);
+			}
+			for (StaticMeshNode &node : nodes) {
+				const u8 *mesh = meshes;
+				for (u32 mi = 0; mi < node.mesh_index && mi < count; mi++) mesh += 12 + 12 * readU32(mesh + 8);
+				if (node.mesh_index >= count) continue;
+
+				u32 batch_count = readU32(mesh + 8);
+				for (u32 bi = 0; bi < batch_count; bi++) {
+					const u8 *batch = mesh + 12 + 12 * bi; // 1i2I material, start, count
+					u32 start = readU32(batch + 4);
+					u32 n = readU32(batch + 8);
+					for (u32 ii = start; ii < start + n && ii < index_count; ii++) {
+						u16 index;
+						memcpy(&index, indices + 2 * ii, sizeof(index));
+						if (index >= array_vertex_count) continue;
+						const u8 *v = vertex_array + vertex_size * index;
+						vec3 pos = v3(readF32(v), readF32(v+4), readF32(v+8));
+						const u8 *vn = v + attrib_offsets[1];
+						vec3 nor = v3(readF32(vn), readF32(vn+4), readF32(vn+8));
+						pos = node.location + rotateByQuat(node.rotation, v3(node.scale.x*pos.x, node.scale.y*pos.y, node.scale.z*pos.z));
+						nor = normalize(rotateByQuat(node.rotation, nor));
+						float u = 0.0f, t = 0.0f;
+						if (attrib_counts[3] == 2) { // VAT_TEXCOORD0
+							u = readF32(v + attrib_offsets[3]);
+							t = readF32(v + attrib_offsets[3] + 4);
+						}
+						float vertex[STATIC_MESH_VERTEX_SIZE] = {pos.x, pos.y, pos.z, nor.x, nor.y, nor.z, u, t};
+						vertices.insert(vertices.end(), vertex, vertex + STATIC_MESH_VERTEX_SIZE);
+						vertex_count++;
+					}
+				}
+			}
+			break;
+		}
+
+		p = chunk + chunk_size;
+	}
+
+	if (vertex_count == 0) {
+		LOGE("No triangles in model: %s", filename);
+		return false;
+	}
+	return true;
+}
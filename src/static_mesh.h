@@ -0,0 +1,11 @@
+const int STATIC_MESH_VERTEX_SIZE = 8; // floats: position, normal, texcoord
+
+// the triangles of an .mdl file (see scripts/blender/model_mdl.py) as a flat vertex array
+// node transforms are applied and indices expanded, so copies can be batched into one buffer
+struct StaticMesh {
+	std::vector<float> vertices;
+	int vertex_count = 0;
+	char material[64] = ""; // image path of the first material, see getTextureFilename
+
+	bool load(const char *filename);
+};
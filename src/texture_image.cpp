@@ -0,0 +1,85 @@
+bool TextureImage::load(const char *filename) {
+	width = 0;
+	height = 0;
+	pixels.clear();
+
+	AssetData asset;
+	if (!asset.load(filename)) {
+		LOGE("Could not open texture: %s", filename);
+		return false;
+	}
+	const u8 *data = asset.data;
+	if (asset.size < 18) {
+		LOGE("Not a tga file: %s", filename);
+		return false;
+	}
+
+	// 18 byte header: id length, color map type, image type, color map spec, origin, size, bits per pixel, descriptor
+	u8 image_type = data[2];
+	u16 color_map_length = (u16)(data[5] | data[6] << 8);
+	int w = data[12] | data[13] << 8;
+	int h = data[14] | data[15] << 8;
+	int bytes_per_pixel = data[16] / 8;
+	if ((image_type != 2 && image_type != 10) || (bytes_per_pixel != 3 && bytes_per_pixel != 4) || w == 0 || h == 0) {
+		LOGE("Unsupported tga file: %s", filename); // only true color, raw or run length encoded
+		return false;
+	}
+
+	const u8 *p = data + 18 + data[0] + color_map_length * ((data[7] + 7) / 8);
+	const u8 *end = data + asset.size;
+	size_t pixel_count = (size_t)w * (size_t)h;
+	pixels.resize(4 * pixel_count);
+	u8 *out = pixels.data();
+	for (size_t i = 0; i < pixel_count;) {
+		size_t run = 1;
+		bool repeat = false; // one pixel for the whole run
+		if (image_type == 10) {
+			if (p >= end) break;
+			run = (*p & 0x7f) + 1u;
+			repeat = (*p & 0x80) != 0;
+			p++;
+		}
+		if (end - p < (repeat ? 1 : (ptrdiff_t)run) * bytes_per_pixel) break;
+		for (size_t k = 0; k < run && i < pixel_count; k++, i++) {
+			out[0] = p[2]; // bgra
+			out[1] = p[1];
+			out[2] = p[0];
+			out[3] = bytes_per_pixel == 4 ? p[3] : 255;
+			out += 4;
+			if (!repeat) p += bytes_per_pixel;
+		}
+		if (repeat) p += bytes_per_pixel;
+	}
+	if (out != pixels.data() + pixels.size()) {
+		LOGE("Truncated tga file: %s", filename);
+		pixels.clear();
+		return false;
+	}
+
+	width = w;
+	height = h;
+	return true;
+}
+
+GLuint TextureImage::upload(GLint filter) {
+	if (pixels.empty()) return 0;
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	std::vector<u8>().swap(pixels);
+	return texture;
+}
+
+bool getTextureFilename(const char *material, char *filename, size_t filename_size) {
+	if (!material[0]) return false;
+	const char *name = material;
+	for (const char *c = material; *c; c++) {
+		if (*c == '/' || *c == '\\') name = c + 1; // blender paths may use either
+	}
+	snprintf(filename, filename_size, "data/gfx/%s.tga", name);
+	return true;
+}
@@ -0,0 +1,17 @@
+// the pixels of a .tga that compile_assets.py converted from assets/gfx, decoded from AssetData
+// so it can happen on a worker thread, only upload needs gl
+struct TextureImage {
+	int width = 0;
+	int height = 0;
+	std::vector<u8> pixels; // rgba, rows in file order (the pipeline flips them for gl)
+
+	bool load(const char *filename);
+	GLuint upload(GLint filter); // frees the pixels, 0 if there are none
+	size_t getTextureSize() { return 4 * (size_t)width * (size_t)height; }
+};
+
+const int TEXTURE_FILENAME_SIZE = 96;
+
+// model_mdl.py stores a material's image path without extension, its converted file is data/gfx/<name>.tga
+// false for models without a material
+bool getTextureFilename(const char *material, char *filename, size_t filename_size);
@@ -1,72 +1,57 @@
-const int TR_VA_POSITION = 0;
-const int TR_VA_NORMAL = 1;
-
-MDLModel Track::finish_line_model;
-
-Shader Track::_shader;
-GLint Track::_mvp_loc;
-GLint Track::_color_loc;
-
-void Track::init() {
-	char vert_source[] = {
-		"uniform mat4 mvp;							\n"
-		"attribute vec3 position;					\n"
-		"attribute vec3 normal;						\n"
-		"varying vec3 v_normal;						\n"
-		"varying float v_abyss;						\n"
-		"void main() {								\n"
-		"	v_normal = normal;						\n"
-		"	v_abyss = 1.0;							\n"
-		"	if (position.z < 1.0) v_abyss = 0.0;	\n"
-		"	gl_Position = mvp * vec4(position, 1.0);\n"
-		"}											\n"
-	};
-
-	char frag_source[] = {
-		"#ifdef GL_ES								\n"
-		"precision mediump float;					\n"
-		"#endif										\n"
-		"uniform vec4 color;						\n"
-		"varying vec3 v_normal;						\n"
-		"varying float v_abyss;						\n"
-		"void main() {								\n"
-		"	vec3 light = normalize(vec3(0.2, 0.3, -1.0));\n"
-		"	vec3 normal = normalize(v_normal);		\n"
-		"	float shade = 0.75 + 0.25*dot(normal, -light);\n"
-		"	float dist = (gl_FragCoord.z / gl_FragCoord.w) / 400.0;\n"
-		"	float fog = 1.0 - dist*dist;\n"
-		"	shade *= v_abyss * fog;\n"
-		"	gl_FragColor = vec4(shade*color.rgb, color.a);\n"
-		"}											\n"
-	};
-	_shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
-	_shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
-	_shader.bindVertexAttrib("position", TR_VA_POSITION);
-	_shader.bindVertexAttrib("normal", TR_VA_NORMAL);
-	_shader.link();
-	_shader.use();
-	_mvp_loc = _shader.getUniformLocation("mvp");
-	_color_loc = _shader.getUniformLocation("color");
-
-	finish_line_model.load("data/models/finish_line.mdl");
-}
+const float SEGMENT_MAX_LENGTH = 30.0f;
+
+void Track::generate(float difficulty, u64 seed, vec2 sp, vec2 sdir, float swidth) {
+	RandomStream random(seed, STREAM_TRACK);
+
+	// first segment
+	TrackSegment s;
+	s.p = sp;
+	s.dir = sdir;
+	s.t = v2(s.dir.y, -s.dir.x);
+	s.dims.x = swidth;
+	s.dims.y = SEGMENT_MAX_LENGTH; // initial length
+	s.dims.z = 50.0f; // initial height
 
-void Track::destroy() {
-	_shader.destroy();
-	finish_line_model.destroy();
+	start_distance = 0.0f;
+	gas_tank_distance = 0.0f;
+	has_finish_line = true;
+	generatePath(difficulty, &random, s, getLevelLength(difficulty));
 }
 
-float rand_rangef(float min, float max) {
-	return min + randf() * (max - min);
+void Track::generateChunk(float difficulty, u64 seed, Track *prev, float chunk_length) {
+	RandomStream random(seed, STREAM_TRACK);
+
+	TrackSegment s;
+	s.dims.y = SEGMENT_MAX_LENGTH;
+	if (prev) { // continue where prev ends
+		TrackSegment &ps = prev->segments.back();
+		s.p = ps.p + ps.dims.y * ps.dir;
+		s.dir = ps.dir;
+		s.t = ps.t;
+		s.dims.x = ps.dims.x;
+		s.dims.z = ps.dims.z;
+		start_distance = prev->start_distance + prev->length;
+		gas_tank_distance = prev->gas_tank_distance;
+	} else { // same start as generate
+		s.p = v2(0.0f);
+		s.dir = v2(0.0f, 1.0f);
+		s.t = v2(s.dir.y, -s.dir.x);
+		s.dims.x = 18.0f;
+		s.dims.z = 50.0f;
+		start_distance = 0.0f;
+		gas_tank_distance = 0.0f;
+	}
+	has_finish_line = false;
+	generatePath(difficulty, &random, s, chunk_length);
 }
 
-void Track::generate(float difficulty, vec2 sp, vec2 sdir, float swidth) {
-	const float GAS_TANK_INTERVAL = 400.0f + 400.0f*difficulty;
-	float max_distance = 1904.0f + 1000.0f*difficulty; // in meters
+// appends segments to s until max_distance meters are covered
+void Track::generatePath(float difficulty, RandomStream *random, TrackSegment s, float max_distance) {
+	PROFILE_SCOPE("Track::generate");
+	const float GAS_TANK_INTERVAL = balance->gas_tank_interval + balance->gas_tank_interval_per_difficulty*difficulty;
 	const float segment_min_width = 16.0f;
 	const float segment_max_width = 20.0f;
 	const float segment_min_length = 20.0f;
-	const float segment_max_length = 30.0f;
 	const float segment_min_height = 10.0f;
 	const float segment_max_height_delta = 0.0f; //2.0f;
 	const float segment_angle_max_delta = 0.125f * (float)M_PI; // 22.5°
@@ -76,33 +61,27 @@ void Track::generate(float difficulty, vec2 sp, vec2 sdir, float swidth) {
 	// clear old
 	segments.clear();
 	pickups.clear();
+	segment_pickups.clear();
 
 	// generate a path of segments
-	TrackSegment s; // current segment
-	s.p = sp;
-	s.dir = sdir;
-	s.t = v2(s.dir.y, -s.dir.x);
-	s.dims.x = swidth;
-	s.dims.y = segment_max_length; // initial length
-	s.dims.z = 50.0f; // initial height
-
-	float gas_tank_placed_at = 0.0f;
+	float gas_tank_placed_at = gas_tank_distance - start_distance;
 
 	while (distance < max_distance) {
-		s.distance = distance;
+		segment_pickups.push_back((u32)pickups.size()); // placed in segment order
+		s.distance = start_distance + distance;
 		distance += s.dims.y;
 
 		if (distance - gas_tank_placed_at > GAS_TANK_INTERVAL) {
 			// place gas tank
-			float x = rand_rangef(-0.5f*s.dims.x + 2.0f, 0.5f*s.dims.x - 2.0f);
-			float y = randf() * s.dims.y;
+			float x = random->rangef(-0.5f*s.dims.x + 2.0f, 0.5f*s.dims.x - 2.0f);
+			float y = random->nextf() * s.dims.y;
 			float z = s.dims.z;
 			pickups.push_back(Pickup(PT_GAS_TANK, v3(s.p + x*s.t + y*s.dir, z)));
 			gas_tank_placed_at = distance;
 		}
-		if (randf() < difficulty) { // place obstacle on this segment
-			float x = rand_rangef(-0.5f*s.dims.x + 2.0f, 0.5f*s.dims.x - 2.0f);
-			float y = randf() * s.dims.y;
+		if (random->nextf() < difficulty) { // place obstacle on this segment
+			float x = random->rangef(-0.5f*s.dims.x + 2.0f, 0.5f*s.dims.x - 2.0f);
+			float y = random->nextf() * s.dims.y;
 			float z = s.dims.z;
 			pickups.push_back(Pickup(PT_OIL_SPILL, v3(s.p + x*s.t + y*s.dir, z)));
 		}
@@ -111,13 +90,13 @@ void Track::generate(float difficulty, vec2 sp, vec2 sdir, float swidth) {
 
 		s.p = s.p + s.dims.y * s.dir;
 
-		s.dims.x = rand_rangef(segment_min_width, segment_max_width);
-		s.dims.y = rand_rangef(segment_min_length, segment_max_length);
+		s.dims.x = random->rangef(segment_min_width, segment_max_width);
+		s.dims.y = random->rangef(segment_min_length, SEGMENT_MAX_LENGTH);
 		s.dims.y = fminf(s.dims.y, max_distance - distance + 0.99f); // clamp
-		s.dims.z = s.dims.z + randf() * segment_max_height_delta;
+		s.dims.z = s.dims.z + random->nextf() * segment_max_height_delta;
 
 		float angle = angleFromDir(s.dir);
-		angle += rand_rangef(-segment_angle_max_delta, segment_angle_max_delta); // modify angle
+		angle += random->rangef(-segment_angle_max_delta, segment_angle_max_delta); // modify angle
 
 		s.dir = dirFromAngle(angle);
 		s.dir = mix(s.dir, v2(0.0f, 1.0f), 0.1f * (1.0f - s.dir.y*s.dir.y)); // straighten
@@ -127,74 +106,36 @@ void Track::generate(float difficulty, vec2 sp, vec2 sdir, float swidth) {
 		s.t = v2(s.dir.y, -s.dir.x);
 	}
 
+	segment_pickups.push_back((u32)pickups.size());
+
 	length = distance;
+	gas_tank_distance = start_distance + gas_tank_placed_at;
+	collision.build(this);
+	revision++;
+}
 
-	// generate mesh from path
-	std::vector<vec3> points;
-	std::vector<int> indices;
-	const int POINTS_PER_SEGMENT = 4;
-	points.reserve((segments.size()+1)*POINTS_PER_SEGMENT);
-	for (size_t i = 0; i < segments.size(); i++) {
-		s = segments[i];
-		points.push_back(v3(s.p - 0.5f * s.dims.x * s.t, 0.0f));
-		points.push_back(v3(s.p - 0.5f * s.dims.x * s.t, s.dims.z));
-		points.push_back(v3(s.p + 0.5f * s.dims.x * s.t, s.dims.z));
-		points.push_back(v3(s.p + 0.5f * s.dims.x * s.t, 0.0f));
-	}
-	points.push_back(v3(s.p + s.dir*s.dims.y - 0.5f * s.dims.x * s.t, 0.0f));
-	points.push_back(v3(s.p + s.dir*s.dims.y - 0.5f * s.dims.x * s.t, s.dims.z));
-	points.push_back(v3(s.p + s.dir*s.dims.y + 0.5f * s.dims.x * s.t, s.dims.z));
-	points.push_back(v3(s.p + s.dir*s.dims.y + 0.5f * s.dims.x * s.t, 0.0f));
-
-	indices.reserve(segments.size()*3*6);
-	for (int i = 0; i < (int)segments.size(); i++) {
-		for (int j = 0; j < 3; j++) {
-			indices.push_back(POINTS_PER_SEGMENT * i + j);
-			indices.push_back(POINTS_PER_SEGMENT * i + j + 1);
-			indices.push_back(POINTS_PER_SEGMENT * (i+1) + j);
-
-			indices.push_back(POINTS_PER_SEGMENT * (i+1) + j + 1);
-			indices.push_back(POINTS_PER_SEGMENT * (i+1) + j);
-			indices.push_back(POINTS_PER_SEGMENT * i + j + 1);
-		}
-	}
+void Track::clear() {
+	segments.clear();
+	pickups.clear();
+	segment_pickups.clear();
+	collision.clear();
+	length = 0.0f;
+	revision++;
+}
 
-	#if 0 // indexed debug drawing
-	debug_renderer.setColor(0.0f, 0.0f, 0.0f, 1.0f);
-	for (size_t i = 0; i < indices.size(); i += 3) {
-		int i0 = indices[i];
-		int i1 = indices[i+1];
-		int i2 = indices[i+2];
-		debug_renderer.drawTriangle(points[i0], points[i1], points[i2]);
-	}
-	#endif
-
-	// make mesh with per face normals
-	_vertex_count = (int)indices.size();
-	size_t face_count = (size_t)_vertex_count / 3;
-	ARRAY_FREE(_vertex_data);
-	_vertex_data = new float[6*_vertex_count]; // for position and normal
-	vec3 p[3]; float *vdp = _vertex_data; // pointer to current vertex
-	for (size_t fi = 0; fi < face_count; fi++) {
-		p[0] = points[(size_t)indices[3*fi+0]];
-		p[1] = points[(size_t)indices[3*fi+1]];
-		p[2] = points[(size_t)indices[3*fi+2]];
-		vec3 nor = normalize(cross(p[1]-p[0], p[2]-p[0]));
-
-		for (int vi = 0; vi < 3; vi++) {
-			vdp[0] = p[vi].x; vdp[1] = p[vi].y; vdp[2] = p[vi].z;
-			vdp[3] = nor.x;   vdp[4] = nor.y;   vdp[5] = nor.z;
-			vdp += 6;
-		}
-	}
+void Track::translate(vec2 offset) {
+	for (TrackSegment &s : segments) s.p += offset;
+	for (Pickup &p : pickups) p.position += v3(offset, 0.0f);
+	collision.translate(offset);
+}
 
-	// upload vertex data
-	if (!_vbo) glGenBuffers(1, &_vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(sizeof(float)*6*indices.size()), _vertex_data, GL_STATIC_DRAW);
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+void Track::getMemoryUsage(MemoryReport *report) {
+	report->add(MT_TRACK, vectorBytes(segments) + vectorBytes(segment_pickups) + vectorBytes(collision.triangles)
+		+ vectorBytes(collision.dist_x) + vectorBytes(collision.dist_y) + vectorBytes(collision.dist_w));
+	report->add(MT_PICKUPS, vectorBytes(pickups));
 }
 
+// reference implementation, queries use the precomputed TrackCollision instead
 bool isPointInTriangle(vec3 p, vec3 a, vec3 b, vec3 c) {
 	a -= p; b -= p; c -= p;
 	vec3 u = cross(b, c);
@@ -217,69 +158,40 @@ bool traceQuadZ(vec2 p, float *z, vec3 q0, vec3 q1, vec3 q2, vec3 q3) {
 		traceTriangleZ(p, z, q3, q2, q1);
 }
 
-// copy pasta!
-TrackSegment *Track::findNearestSegment(vec2 p) {
-	// binary search potential segments
-	// this only works because segments are ordered in y direction
-
-	size_t li = 0; // lower bound
-	size_t ui = segments.size()-1; // upper bound
-	while (li <= ui) {
-		size_t pi = (li+ui)/2; // pivot
-		TrackSegment &s = segments[pi];
-		vec3 b0 = v3(s.p - 0.5f*s.dims.x*s.t, s.dims.z);
-		vec3 b1 = v3(s.p + 0.5f*s.dims.x*s.t, s.dims.z);
-
-		bool is_below = p.y < fminf(b0.y, b1.y);
-
-		if (!is_below) { // so is it above?
-			vec2 tp = s.p + s.dir*s.dims.y;
-			vec2 dir = s.dir;
-			vec3 t0 = v3(tp - 0.5f*s.dims.x*s.t, s.dims.z);
-			vec3 t1 = v3(tp + 0.5f*s.dims.x*s.t, s.dims.z);
-			if (pi+1 < segments.size()) {
-				TrackSegment ns = segments[pi+1];
-				dir = ns.dir;
-				t0 = v3(ns.p - 0.5f*ns.dims.x*ns.t, ns.dims.z);
-				t1 = v3(ns.p + 0.5f*ns.dims.x*ns.t, ns.dims.z);
-			}
-
-			bool is_above = p.y > fmaxf(t0.y, t1.y);
-
-			if (!is_above) {
-				// precisely check below
-				float dp = dot(s.dir, p-s.p);
-				is_below = dp < 0.0f;
-
-				if (!is_below) {
-					// precisely check above
-					is_above = dot(dir, p-tp) > 0.0f;
-
-					// we found a segment
-					if (!is_above) {
-						return &s;
-					}
-				}
-			}
-		}
-
-		// iterate
-		if (is_below) {
-			if (pi == 0) break; // prevent integer underflow
-			ui = pi - 1;
-		} else { // above
-			li = pi + 1;
-		}
+// corners of a segment's top: b0, b1 at its start, t0, t1 at its end (the next segment's start)
+void Track::getSegmentCorners(size_t i, vec3 *b0, vec3 *b1, vec3 *t0, vec3 *t1, vec2 *tdir) {
+	TrackSegment &s = segments[i];
+	*b0 = v3(s.p - 0.5f*s.dims.x*s.t, s.dims.z);
+	*b1 = v3(s.p + 0.5f*s.dims.x*s.t, s.dims.z);
+
+	vec2 tp = s.p + s.dir*s.dims.y;
+	*tdir = s.dir;
+	*t0 = v3(tp - 0.5f*s.dims.x*s.t, s.dims.z);
+	*t1 = v3(tp + 0.5f*s.dims.x*s.t, s.dims.z);
+	if (i+1 < segments.size()) {
+		TrackSegment &ns = segments[i+1];
+		*tdir = ns.dir;
+		*t0 = v3(ns.p - 0.5f*ns.dims.x*ns.t, ns.dims.z);
+		*t1 = v3(ns.p + 0.5f*ns.dims.x*ns.t, ns.dims.z);
 	}
+}
+
+int Track::classifySegment(size_t i, vec2 p) {
+	TrackSegment &s = segments[i];
+	vec3 b0, b1, t0, t1; vec2 dir;
+	getSegmentCorners(i, &b0, &b1, &t0, &t1, &dir);
 
-	if (ui == 0) return &segments[0];
-	if (li >= segments.size()-1) return &segments[segments.size()-1];
+	// cheap checks first
+	if (p.y < fminf(b0.y, b1.y)) return -1;
+	if (p.y > fmaxf(t0.y, t1.y)) return 1;
 
-	assert(false);
-	return nullptr;
+	// precisely check below and above
+	if (dot(s.dir, p-s.p) < 0.0f) return -1;
+	if (dot(dir, p-(s.p + s.dir*s.dims.y)) > 0.0f) return 1;
+	return 0;
 }
 
-bool Track::traceZ(vec2 p, float *z, float *distance) {
+int Track::searchSegment(vec2 p, size_t *index) {
 	// binary search potential segments
 	// this only works because segments are ordered in y direction
 
@@ -287,46 +199,14 @@ bool Track::traceZ(vec2 p, float *z, float *distance) {
 	size_t ui = segments.size()-1; // upper bound
 	while (li <= ui) {
 		size_t pi = (li+ui)/2; // pivot
-		TrackSegment s = segments[pi];
-		vec3 b0 = v3(s.p - 0.5f*s.dims.x*s.t, s.dims.z);
-		vec3 b1 = v3(s.p + 0.5f*s.dims.x*s.t, s.dims.z);
-
-		bool is_below = p.y < fminf(b0.y, b1.y);
-
-		if (!is_below) { // so is it above?
-			vec2 tp = s.p + s.dir*s.dims.y;
-			vec2 dir = s.dir;
-			vec3 t0 = v3(tp - 0.5f*s.dims.x*s.t, s.dims.z);
-			vec3 t1 = v3(tp + 0.5f*s.dims.x*s.t, s.dims.z);
-			if (pi+1 < segments.size()) {
-				TrackSegment ns = segments[pi+1];
-				dir = ns.dir;
-				t0 = v3(ns.p - 0.5f*ns.dims.x*ns.t, ns.dims.z);
-				t1 = v3(ns.p + 0.5f*ns.dims.x*ns.t, ns.dims.z);
-			}
-
-			bool is_above = p.y > fmaxf(t0.y, t1.y);
-
-			if (!is_above) {
-				// precisely check below
-				float dp = dot(s.dir, p-s.p);
-				is_below = dp < 0.0f;
-
-				if (!is_below) {
-					// precisely check above
-					is_above = dot(dir, p-tp) > 0.0f;
-
-					// we found a segment
-					if (!is_above) {
-						if (distance) *distance = s.distance + dp;
-						return traceQuadZ(p, z, b0, b1, t0, t1);
-					}
-				}
-			}
+		int side = classifySegment(pi, p);
+		if (side == 0) { // we found a segment
+			*index = pi;
+			return 0;
 		}
 
 		// iterate
-		if (is_below) {
+		if (side < 0) { // below
 			if (pi == 0) break; // prevent integer underflow
 			ui = pi - 1;
 		} else { // above
@@ -334,45 +214,27 @@ bool Track::traceZ(vec2 p, float *z, float *distance) {
 		}
 	}
 
-	return false; // not on track
+	if (ui == 0) {
+		*index = 0;
+		return -1;
+	}
+	// sharp turns can break the y ordering, then li is the best guess
+	*index = li < segments.size() ? li : segments.size()-1;
+	return 1;
 }
 
-void Track::draw(mat4 view_proj_mat) {
-	//if (_vertex_count == 0) return;
-
-	//glDisable(GL_DEPTH_TEST);
-
-	if (!_vbo) return;
-
-	glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-
-	// configure vertex array
-	glEnableVertexAttribArray((GLuint)TR_VA_POSITION);
-	glVertexAttribPointer((GLuint)TR_VA_POSITION, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (GLvoid*)0);
-	glEnableVertexAttribArray((GLuint)TR_VA_NORMAL);
-	glVertexAttribPointer((GLuint)TR_VA_NORMAL, 3, GL_FLOAT, GL_FALSE, 6*sizeof(float), (GLvoid*)(3*sizeof(float)));
-
-	// configure shader
-	_shader.use();
-	glUniformMatrix4fv(_mvp_loc, 1, GL_FALSE, view_proj_mat.e);
-	glUniform4f(_color_loc, 0.9f, 0.85f, 0.6f, 1.0f);
-
-	glDrawArrays(GL_TRIANGLES, 0, _vertex_count);
-
-	glDisableVertexAttribArray((GLuint)TR_VA_POSITION);
-	glDisableVertexAttribArray((GLuint)TR_VA_NORMAL);
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
+bool Track::traceSegmentZ(size_t i, vec2 p, float *z, float *distance) {
+	return collision.traceZ(i, p, z, distance);
+}
 
-	// draw all the pickups
-	for (Pickup &p : pickups) {
-		p.draw(view_proj_mat);
-	}
+TrackSegment *Track::findNearestSegment(vec2 p) {
+	size_t i;
+	searchSegment(p, &i);
+	return &segments[i];
+}
 
-	// draw the finish line
-	TrackSegment &s = segments.back();
-	mat4 model_mat = translationMatrix(v3(s.p, s.dims.z))
-		* m4(rotationMatrix(v3(0.0f, 0.0f, 1.0f), angleFromDir(s.dir) + 0.5f*(float)M_PI) 
-		* scaleMatrix(v3(0.5f*s.dims.x, 1.0f, 1.0f)));
-	finish_line_model.draw(view_proj_mat * model_mat);
+bool Track::traceZ(vec2 p, float *z, float *distance) {
+	size_t i;
+	if (searchSegment(p, &i) != 0) return false; // not on track
+	return traceSegmentZ(i, p, z, distance);
 }
\ No newline at end of file
@@ -12,31 +12,59 @@ struct TrackSegment {
 
 const int TR_MAX_VERTEX_COUNT = 1024;
 
-class Track {
-public:
-	static void init();
-	static void destroy();
+struct TrackMesh; // render side, see track_render.h
 
-	static MDLModel finish_line_model;
+// meters of path Track::generate aims for, harder levels are longer
+inline float getLevelLength(float difficulty) { return 1904.0f + 1000.0f * difficulty; }
 
+class Track {
+public:
 	// difficulty 0: no obstacles, 1: full of obstacles
-	void generate(float difficulty, vec2 sp = v2(0.0f), vec2 sdir = v2(0.0f, 1.0f), float swidth = 18.0f);
+	// only depends on its arguments, the same seed always yields the same track
+	void generate(float difficulty, u64 seed, vec2 sp = v2(0.0f), vec2 sdir = v2(0.0f, 1.0f), float swidth = 18.0f);
+	// endless mode: seamlessly continues prev (the first chunk if null) with a chunk of about chunk_length meters
+	void generateChunk(float difficulty, u64 seed, Track *prev, float chunk_length);
+	float start_distance = 0.0f; // accumulated distance at the first segment, only non zero for chunks
 	float length; // in meters
+	float gas_tank_distance; // accumulated distance of the last gas tank placed
+	bool has_finish_line; // false for chunks
+	int revision = 0; // incremented by generate
+	const GameBalance *balance = &default_balance; // gas tank placement
+
+	void clear();
+	void translate(vec2 offset); // moves the whole track, keeps the mesh
 
+	// stateless queries, see TrackCursor for repeated ones
 	TrackSegment *findNearestSegment(vec2 p);
 	bool traceZ(vec2 p, float *z, float *distance = nullptr); // true if on track
 
-	void draw(mat4 view_proj_mat);
+	// -1: p is before segment i, 1: after it, 0: on it
+	int classifySegment(size_t i, vec2 p);
+	// binary search, 0 if p is on segment *index, otherwise the side of the track and the nearest end
+	int searchSegment(vec2 p, size_t *index);
+	bool traceSegmentZ(size_t i, vec2 p, float *z, float *distance = nullptr);
+	void getSegmentCorners(size_t i, vec3 *b0, vec3 *b1, vec3 *t0, vec3 *t1, vec2 *tdir);
+
+	void getMemoryUsage(MemoryReport *report);
 
 	std::vector<Pickup> pickups;
 	std::vector<TrackSegment> segments;
+	std::vector<u32> segment_pickups; // pickups on segment i are [segment_pickups[i], segment_pickups[i+1])
+	TrackCollision collision; // derived from segments
+
+	// render side (track_render.cpp), not available in headless builds
+	static void loadFinishLine(); // cpu part of initRender, may run on another thread before it
+	static void initRender();
+	static void destroyRender();
+	static void prepareMesh(Track *track); // cpu part of the mesh, for TrackGenerator::prepare
+	bool uploadMesh(size_t max_bytes); // true when the mesh is ready to draw
+	void destroyMesh();
+	void draw(mat4 view_proj_mat, float delta_time);
+	void getMeshMemoryUsage(MemoryReport *report);
 
 private:
-	float *_vertex_data = nullptr;
-	int _vertex_count;
-
-	static Shader _shader;
-	static GLint _mvp_loc;
-	static GLint _color_loc;
-	GLuint _vbo = 0;
-};
\ No newline at end of file
+	void generatePath(float difficulty, RandomStream *random, TrackSegment s, float max_distance);
+
+public:
+	TrackMesh *mesh = nullptr; // built from segments on demand, stays null when headless
+};
@@ -0,0 +1,98 @@
+void TrackCollision::clear() {
+	triangles.clear();
+	dist_x.clear(); dist_y.clear(); dist_w.clear();
+}
+
+void TrackCollision::build(Track *track) {
+	clear();
+
+	for (size_t i = 0; i < track->segments.size(); i++) {
+		TrackSegment &s = track->segments[i];
+		vec3 b0, b1, t0, t1; vec2 tdir;
+		track->getSegmentCorners(i, &b0, &b1, &t0, &t1, &tdir);
+
+		// same triangles as traceQuadZ
+		vec3 tris[2][3] = {{b0, b1, t0}, {t1, t0, b1}};
+		for (int ti = 0; ti < 2; ti++) {
+			vec3 *v = tris[ti];
+			TrackTriangle tri;
+
+			// flip the edges of clockwise triangles, so inside is positive either way
+			vec3 n = cross(v[1]-v[0], v[2]-v[0]);
+			float winding = n.z < 0.0f ? -1.0f : 1.0f;
+			for (int e = 0; e < 3; e++) {
+				vec3 a = v[e];
+				vec3 b = v[(e+1) % 3];
+				tri.row_x[e] = -(b.y - a.y) * winding;
+				tri.row_y[e] = (b.x - a.x) * winding;
+				tri.row_w[e] = -(tri.row_x[e]*a.x + tri.row_y[e]*a.y);
+			}
+
+			// plane
+			tri.row_x[3] = -n.x / n.z;
+			tri.row_y[3] = -n.y / n.z;
+			tri.row_w[3] = dot(n, v[0]) / n.z;
+
+			triangles.push_back(tri);
+		}
+
+		dist_x.push_back(s.dir.x);
+		dist_y.push_back(s.dir.y);
+		dist_w.push_back(s.distance - dot(s.dir, s.p));
+	}
+}
+
+void TrackCollision::translate(vec2 offset) {
+	for (TrackTriangle &tri : triangles) {
+		for (int r = 0; r < 4; r++) {
+			tri.row_w[r] -= tri.row_x[r]*offset.x + tri.row_y[r]*offset.y;
+		}
+	}
+	for (size_t i = 0; i < dist_w.size(); i++) {
+		dist_w[i] -= dist_x[i]*offset.x + dist_y[i]*offset.y;
+	}
+}
+
+bool TrackCollision::traceZ(size_t i, vec2 p, float *z, float *distance) {
+	if (distance) *distance = dist_x[i]*p.x + dist_y[i]*p.y + dist_w[i];
+	for (size_t ti = 2*i; ti < 2*i+2; ti++) {
+		TrackTriangle &tri = triangles[ti];
+		float r[4];
+		for (int k = 0; k < 4; k++) r[k] = tri.row_x[k]*p.x + tri.row_y[k]*p.y + tri.row_w[k];
+		*z = r[3];
+		if (r[0] >= 0.0f && r[1] >= 0.0f && r[2] >= 0.0f) return true;
+	}
+	return false;
+}
+
+void TrackCollision::traceZ(int count, const vec2 *points, const size_t *segments, float *z, bool *hits, float *distances) {
+#ifdef __SSE2__
+	for (int i = 0; i < count; i++) {
+		__m128 x = _mm_set1_ps(points[i].x);
+		__m128 y = _mm_set1_ps(points[i].y);
+		TrackTriangle *tri = &triangles[2*segments[i]];
+
+		// both triangles of the segment
+		__m128 r0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_loadu_ps(tri[0].row_x)),
+			_mm_mul_ps(y, _mm_loadu_ps(tri[0].row_y))), _mm_loadu_ps(tri[0].row_w));
+		__m128 r1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_loadu_ps(tri[1].row_x)),
+			_mm_mul_ps(y, _mm_loadu_ps(tri[1].row_y))), _mm_loadu_ps(tri[1].row_w));
+		int inside0 = (_mm_movemask_ps(_mm_cmpge_ps(r0, _mm_setzero_ps())) & 7) == 7;
+		int inside1 = (_mm_movemask_ps(_mm_cmpge_ps(r1, _mm_setzero_ps())) & 7) == 7;
+
+		// the first triangle wins, like in the scalar version
+		float rz[4];
+		_mm_storeu_ps(rz, inside0 ? r0 : r1);
+		z[i] = rz[3];
+		hits[i] = inside0 || inside1;
+		if (distances) {
+			size_t s = segments[i];
+			distances[i] = dist_x[s]*points[i].x + dist_y[s]*points[i].y + dist_w[s];
+		}
+	}
+#else
+	for (int i = 0; i < count; i++) {
+		hits[i] = traceZ(segments[i], points[i], &z[i], distances ? &distances[i] : nullptr);
+	}
+#endif
+}
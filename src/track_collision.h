@@ -0,0 +1,27 @@
+class Track;
+
+// plane and edge equations of every track triangle, precomputed by Track::generate
+// the rows are 4 wide so one triangle is evaluated with a few SIMD instructions:
+// (edge 0, edge 1, edge 2, z) = x * row_x + y * row_y + row_w
+// inside the triangle if all three edges are >= 0
+struct TrackTriangle {
+	float row_x[4];
+	float row_y[4];
+	float row_w[4];
+};
+
+struct TrackCollision {
+	std::vector<TrackTriangle> triangles; // 2 per segment
+	// segment: accumulated distance = dist_x*x + dist_y*y + dist_w
+	std::vector<float> dist_x, dist_y, dist_w;
+
+	void build(Track *track);
+	void clear();
+	void translate(vec2 offset);
+
+	// one point on segment i, true if it's on the track there
+	bool traceZ(size_t i, vec2 p, float *z, float *distance = nullptr);
+	// many points at once, each on its own segment (SIMD where available)
+	// z and hits are written for every point, distances only if not null
+	void traceZ(int count, const vec2 *points, const size_t *segments, float *z, bool *hits, float *distances = nullptr);
+};
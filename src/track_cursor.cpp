@@ -0,0 +1,54 @@
+// walks from the last segment, a binary search is only needed after teleports
+bool TrackCursor::seek(Track *t, vec2 p) {
+	if (t != track || t->revision != revision || index >= t->segments.size()) {
+		track = t;
+		revision = t->revision;
+		return t->searchSegment(p, &index) == 0;
+	}
+
+	size_t i = index;
+	int side = track->classifySegment(i, p);
+	for (int step = 0; side != 0 && step < TRACK_CURSOR_MAX_STEPS; step++) {
+		if (side < 0 ? i == 0 : i+1 == track->segments.size()) break; // off the end
+		i = side < 0 ? i-1 : i+1;
+		int next_side = track->classifySegment(i, p);
+		if (next_side == -side) break; // in between, e.g. off the outside of a turn
+		side = next_side;
+	}
+	if (side == 0) {
+		index = i;
+		return true;
+	}
+
+	return track->searchSegment(p, &index) == 0; // too far, the player was teleported
+}
+
+TrackSegment *TrackCursor::find(Track *t, vec2 p) {
+	seek(t, p);
+	return &track->segments[index];
+}
+
+bool TrackCursor::traceZ(Track *t, vec2 p, float *z, float *distance) {
+	if (!seek(t, p)) return false; // not on track
+	return track->traceSegmentZ(index, p, z, distance);
+}
+
+void TrackCursor::traceZ(Track *t, int count, const vec2 *points, float *z, bool *hits, float *distances) {
+	assert(count <= TRACK_CURSOR_MAX_BATCH);
+	if (count <= 0) return;
+	size_t segments[TRACK_CURSOR_MAX_BATCH] = {};
+	bool found[TRACK_CURSOR_MAX_BATCH];
+	float batch_distances[TRACK_CURSOR_MAX_BATCH];
+	for (int i = 0; i < count; i++) {
+		TrackCursor c = *this;
+		TrackCursor *cursor = i == 0 ? this : &c;
+		found[i] = cursor->seek(t, points[i]);
+		segments[i] = cursor->index;
+	}
+
+	t->collision.traceZ(count, points, segments, z, hits, distances ? batch_distances : nullptr);
+	for (int i = 0; i < count; i++) {
+		hits[i] = hits[i] && found[i];
+		if (distances && found[i]) distances[i] = batch_distances[i];
+	}
+}
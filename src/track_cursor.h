@@ -0,0 +1,20 @@
+const int TRACK_CURSOR_MAX_STEPS = 4; // walking further than this falls back to a binary search
+const int TRACK_CURSOR_MAX_BATCH = 16;
+
+class Track;
+struct TrackSegment;
+
+// remembers the segment of the last query, so following ones close by are O(1)
+struct TrackCursor {
+	Track *track = nullptr;
+	int revision = -1; // of track when index was found
+	size_t index = 0; // segment of the last query
+
+	TrackSegment *find(Track *t, vec2 p); // like Track::findNearestSegment
+	bool traceZ(Track *t, vec2 p, float *z, float *distance = nullptr); // like Track::traceZ
+	// several points close to each other in one batch, the cursor follows the first one
+	// distances are written where a point is next to a segment, even if it's not on the track
+	void traceZ(Track *t, int count, const vec2 *points, float *z, bool *hits, float *distances = nullptr);
+
+	bool seek(Track *t, vec2 p); // moves index to the segment p is on, false if none (index is the nearest end then)
+};
@@ -0,0 +1,115 @@
+void TrackGenerator::init() {
+	_quit = false;
+#ifdef __EMSCRIPTEN__
+	threaded = false;
+#else
+	if (threaded) _thread = std::thread(&TrackGenerator::run, this);
+#endif
+}
+
+void TrackGenerator::destroy() {
+#ifndef __EMSCRIPTEN__
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+		_jobs.clear();
+	}
+	_job_cond.notify_one();
+	if (_thread.joinable()) _thread.join();
+#endif
+}
+
+void TrackGenerator::execute(Job *job) {
+	if (job->prev) {
+		job->track->generateChunk(job->difficulty, job->seed, job->prev, job->chunk_length);
+	} else {
+		job->track->generate(job->difficulty, job->seed, job->sp, job->sdir, job->swidth);
+	}
+	void (*prepare_func)(Track *track) = prepare;
+	if (prepare_func) prepare_func(job->track);
+}
+
+void TrackGenerator::request(Track *track, float difficulty, u64 seed, vec2 sp, vec2 sdir, float swidth) {
+	Job job;
+	job.track = track;
+	job.difficulty = difficulty;
+	job.seed = seed;
+	job.sp = sp;
+	job.sdir = sdir;
+	job.swidth = swidth;
+	job.prev = nullptr;
+	job.chunk_length = 0.0f;
+	push(&job);
+}
+
+void TrackGenerator::requestChunk(Track *track, float difficulty, u64 seed, Track *prev, float chunk_length) {
+	Job job;
+	job.track = track;
+	job.difficulty = difficulty;
+	job.seed = seed;
+	job.prev = prev;
+	job.chunk_length = chunk_length;
+	push(&job);
+}
+
+void TrackGenerator::push(Job *job) {
+#ifndef __EMSCRIPTEN__
+	if (threaded) {
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.push_back(*job);
+		}
+		_job_cond.notify_one();
+		return;
+	}
+#endif
+	execute(job);
+}
+
+bool TrackGenerator::isPending(Track *track) {
+	if (_running == track) return true;
+	for (Job &job : _jobs) {
+		if (job.track == track) return true;
+	}
+	return false;
+}
+
+bool TrackGenerator::isDone(Track *track) {
+#ifdef __EMSCRIPTEN__
+	return true;
+#else
+	if (!threaded) return true;
+	std::lock_guard<std::mutex> lock(_mutex);
+	return !isPending(track);
+#endif
+}
+
+void TrackGenerator::wait(Track *track) {
+#ifndef __EMSCRIPTEN__
+	if (!threaded) return;
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done_cond.wait(lock, [this, track] { return !isPending(track); });
+#endif
+}
+
+void TrackGenerator::run() {
+#ifndef __EMSCRIPTEN__
+	profiler.setThreadName("track generator");
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (;;) {
+		_job_cond.wait(lock, [this] { return _quit || !_jobs.empty(); });
+		if (_quit) break;
+
+		Job job = _jobs.front();
+		_jobs.pop_front();
+		_running = job.track;
+
+		lock.unlock();
+		execute(&job);
+		lock.lock();
+
+		_running = nullptr;
+		_done_cond.notify_all();
+	}
+#endif
+}
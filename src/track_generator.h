@@ -0,0 +1,48 @@
+// generates tracks on a worker thread so level transitions don't stall
+class TrackGenerator {
+public:
+	// optional extra cpu work done on the worker after generating, e.g. building the mesh
+	std::atomic<void (*)(Track *track)> prepare{nullptr}; // may be set while the worker runs
+
+	// false: requests run right away on the caller's thread, e.g. when there are many games running in parallel
+	bool threaded = true; // set before init
+
+	void init();
+	void destroy();
+
+	// the track must not be accessed until isDone returns true or wait returns
+	void request(Track *track, float difficulty, u64 seed, vec2 sp, vec2 sdir, float swidth);
+	// endless mode, prev must stay untouched until the chunk is done
+	void requestChunk(Track *track, float difficulty, u64 seed, Track *prev, float chunk_length);
+	bool isDone(Track *track);
+	void wait(Track *track);
+
+private:
+	struct Job {
+		Track *track;
+		float difficulty;
+		u64 seed;
+		vec2 sp;
+		vec2 sdir;
+		float swidth;
+		Track *prev; // chunk if set
+		float chunk_length;
+	};
+
+	void push(Job *job);
+
+	void execute(Job *job);
+	bool isPending(Track *track); // call with _mutex locked
+	void run(); // worker thread
+
+	std::deque<Job> _jobs;
+	Track *_running = nullptr;
+	bool _quit = false;
+
+#ifndef __EMSCRIPTEN__ // no threads, always runs jobs right away
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _job_cond;
+	std::condition_variable _done_cond;
+#endif
+};
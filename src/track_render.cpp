@@ -0,0 +1,465 @@
+const int TR_VA_POSITION = 0;
+const int TR_VA_NORMAL = 1;
+
+static Shader track_shader;
+static GLuint track_program;
+static GLint track_mvp_loc;
+static GLint track_color_loc;
+
+// the finish line is a static mesh with a texture, until initRender uploads them
+const int FL_VA_POSITION = 0;
+const int FL_VA_NORMAL = 1;
+const int FL_VA_TEXCOORD = 2;
+
+static StaticMesh finish_line_mesh;
+static TextureImage finish_line_image;
+static GLuint finish_line_vbo;
+static GLuint finish_line_texture;
+static int finish_line_vertex_count;
+
+static Shader finish_line_shader;
+static GLuint finish_line_program;
+static GLint finish_line_mvp_loc;
+static GLint finish_line_model_loc;
+static GLint finish_line_colormap_loc;
+
+void Track::loadFinishLine() {
+	finish_line_mesh.load("data/models/finish_line.mdl");
+	char filename[TEXTURE_FILENAME_SIZE];
+	if (getTextureFilename(finish_line_mesh.material, filename, sizeof(filename))) finish_line_image.load(filename);
+}
+
+static void initFinishLineRender() {
+	const char *vert_source =
+	"uniform mat4 mvp;"
+	"uniform mat4 model;"
+	"attribute vec3 position;"
+	"attribute vec3 normal;"
+	"attribute vec2 texcoord;"
+	"varying vec2 v_texcoord;"
+	"varying float v_shade;"
+	"void main() {"
+	"\tvec3 n = normalize((model * vec4(normal, 0.0)).xyz);"
+	"\tv_texcoord = texcoord;"
+	"\tv_shade = 0.75 + 0.25 * dot(n, -normalize(vec3(0.2, 0.3, -1.0)));"
+	"\tgl_Position = mvp * vec4(position, 1.0);"
+	"}";
+
+	const char *frag_source =
+	"#ifdef GL_ES\n"
+	"precision mediump float;\n"
+	"#endif\n"
+	"uniform sampler2D colormap;"
+	"varying vec2 v_texcoord;"
+	"varying float v_shade;"
+	"void main() {"
+	"\tvec4 color = texture2D(colormap, v_texcoord);"
+	"\tif (color.a < 0.01) discard;"
+	"\tgl_FragColor = vec4(v_shade * color.rgb, color.a);"
+	"}";
+
+	finish_line_shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
+	finish_line_shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
+	finish_line_shader.bindVertexAttrib("position", FL_VA_POSITION);
+	finish_line_shader.bindVertexAttrib("normal", FL_VA_NORMAL);
+	finish_line_shader.bindVertexAttrib("texcoord", FL_VA_TEXCOORD);
+	finish_line_shader.link();
+	finish_line_shader.use();
+	finish_line_program = RenderQueue::getCurrentProgram();
+	finish_line_mvp_loc = finish_line_shader.getUniformLocation("mvp");
+	finish_line_model_loc = finish_line_shader.getUniformLocation("model");
+	finish_line_colormap_loc = finish_line_shader.getUniformLocation("colormap");
+
+	size_t buffer_size = vectorBytes(finish_line_mesh.vertices);
+	finish_line_vertex_count = finish_line_mesh.vertex_count;
+	if (finish_line_vertex_count > 0) {
+		glGenBuffers(1, &finish_line_vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, finish_line_vbo);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)buffer_size, finish_line_mesh.vertices.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	std::vector<float>().swap(finish_line_mesh.vertices); // only the gpu needs them now
+	trackAsset(MT_MODELS, 0, buffer_size, finish_line_image.getTextureSize());
+	finish_line_texture = finish_line_image.upload(GL_LINEAR);
+}
+
+void Track::initRender() {
+	char vert_source[] = {
+		"uniform mat4 mvp;							\n"
+		"attribute vec3 position;					\n"
+		"attribute vec4 normal;						\n"
+		"varying vec3 v_normal;						\n"
+		"varying float v_abyss;						\n"
+		"void main() {								\n"
+		"	v_normal = normal.xyz;					\n"
+		"	v_abyss = normal.w;						\n"
+		"	gl_Position = mvp * vec4(position, 1.0);\n"
+		"}											\n"
+	};
+
+	char frag_source[] = {
+		"#ifdef GL_ES								\n"
+		"precision mediump float;					\n"
+		"#endif										\n"
+		"uniform vec4 color;						\n"
+		"varying vec3 v_normal;						\n"
+		"varying float v_abyss;						\n"
+		"void main() {								\n"
+		"	vec3 light = normalize(vec3(0.2, 0.3, -1.0));\n"
+		"	vec3 normal = normalize(v_normal);		\n"
+		"	float shade = 0.75 + 0.25*dot(normal, -light);\n"
+		"	float dist = (gl_FragCoord.z / gl_FragCoord.w) / 400.0;\n"
+		"	float fog = 1.0 - dist*dist;\n"
+		"	shade *= v_abyss * fog;\n"
+		"	gl_FragColor = vec4(shade*color.rgb, color.a);\n"
+		"}											\n"
+	};
+	track_shader.compileAndAttach(GL_VERTEX_SHADER, vert_source);
+	track_shader.compileAndAttach(GL_FRAGMENT_SHADER, frag_source);
+	track_shader.bindVertexAttrib("position", TR_VA_POSITION);
+	track_shader.bindVertexAttrib("normal", TR_VA_NORMAL);
+	track_shader.link();
+	track_shader.use();
+	track_program = RenderQueue::getCurrentProgram();
+	track_mvp_loc = track_shader.getUniformLocation("mvp");
+	track_color_loc = track_shader.getUniformLocation("color");
+
+	initFinishLineRender();
+}
+
+void Track::destroyRender() {
+	track_shader.destroy();
+	finish_line_shader.destroy();
+	if (finish_line_vbo) glDeleteBuffers(1, &finish_line_vbo);
+	glDeleteTextures(1, &finish_line_texture);
+	finish_line_vbo = 0;
+	finish_line_texture = 0;
+}
+
+const int POINTS_PER_SEGMENT = 4; // bottom left, top left, top right, bottom right
+
+static TrackVertex makeTrackVertex(vec3 p, vec3 n, vec3 origin, vec3 scale) {
+	TrackVertex v;
+	for (int k = 0; k < 3; k++) {
+		float q = (p.e[k] - origin.e[k]) / scale.e[k];
+		v.position[k] = (s16)lroundf(32767.0f * fminf(fmaxf(q, -1.0f), 1.0f));
+		v.normal[k] = (s8)lroundf(127.0f * n.e[k]);
+	}
+	v.position[3] = 0;
+	v.normal[3] = p.z < 1.0f ? 0 : 127;
+	return v;
+}
+
+// walls and top between consecutive rows of points
+// the walls are flat shaded, the rows share their top vertices
+static void addTrackRows(const std::vector<vec3> &points, const int *rows, int row_count, vec3 origin, vec3 scale,
+	std::vector<TrackVertex> *vertices, std::vector<u16> *indices) {
+	const vec3 *p = &points[0];
+	for (int r = 0; r < row_count - 1; r++) {
+		int p0 = POINTS_PER_SEGMENT * rows[r];
+		int p1 = POINTS_PER_SEGMENT * rows[r+1];
+		for (int j = 0; j < 3; j += 2) { // left and right wall
+			vec3 nor = normalize(cross(p[p0+j+1] - p[p0+j], p[p1+j] - p[p0+j]));
+			u16 first = (u16)vertices->size();
+			vertices->push_back(makeTrackVertex(p[p0+j], nor, origin, scale));
+			vertices->push_back(makeTrackVertex(p[p0+j+1], nor, origin, scale));
+			vertices->push_back(makeTrackVertex(p[p1+j], nor, origin, scale));
+			vertices->push_back(makeTrackVertex(p[p1+j+1], nor, origin, scale));
+			u16 quad[6] = {first, (u16)(first+1), (u16)(first+2), (u16)(first+3), (u16)(first+2), (u16)(first+1)};
+			indices->insert(indices->end(), quad, quad + 6);
+		}
+	}
+
+	u16 first = (u16)vertices->size();
+	for (int r = 0; r < row_count; r++) {
+		// average of the adjacent top faces
+		vec3 nor = v3(0.0f);
+		int p0 = POINTS_PER_SEGMENT * rows[r > 0 ? r-1 : r];
+		int p1 = POINTS_PER_SEGMENT * rows[r > 0 ? r : r+1];
+		nor += normalize(cross(p[p0+2] - p[p0+1], p[p1+1] - p[p0+1]));
+		if (r > 0 && r < row_count - 1) {
+			p0 = POINTS_PER_SEGMENT * rows[r];
+			p1 = POINTS_PER_SEGMENT * rows[r+1];
+			nor += normalize(cross(p[p0+2] - p[p0+1], p[p1+1] - p[p0+1]));
+		}
+		nor = normalize(nor);
+		int pr = POINTS_PER_SEGMENT * rows[r];
+		vertices->push_back(makeTrackVertex(p[pr+1], nor, origin, scale));
+		vertices->push_back(makeTrackVertex(p[pr+2], nor, origin, scale));
+	}
+	for (int r = 0; r < row_count - 1; r++) {
+		u16 i0 = (u16)(first + 2*r);
+		u16 quad[6] = {i0, (u16)(i0+1), (u16)(i0+2), (u16)(i0+3), (u16)(i0+2), (u16)(i0+1)};
+		indices->insert(indices->end(), quad, quad + 6);
+	}
+}
+
+void TrackMesh::build(Track *track) {
+	std::vector<TrackSegment> &segments = track->segments;
+	TrackSegment s;
+	vec2 o = segments.front().p; // relative to the origin, keeps precision far from the world origin
+
+	// generate mesh from path
+	std::vector<vec3> points;
+	points.reserve((segments.size()+1)*POINTS_PER_SEGMENT);
+	for (size_t i = 0; i < segments.size(); i++) {
+		s = segments[i];
+		points.push_back(v3(s.p - 0.5f * s.dims.x * s.t - o, 0.0f));
+		points.push_back(v3(s.p - 0.5f * s.dims.x * s.t - o, s.dims.z));
+		points.push_back(v3(s.p + 0.5f * s.dims.x * s.t - o, s.dims.z));
+		points.push_back(v3(s.p + 0.5f * s.dims.x * s.t - o, 0.0f));
+	}
+	points.push_back(v3(s.p + s.dir*s.dims.y - 0.5f * s.dims.x * s.t - o, 0.0f));
+	points.push_back(v3(s.p + s.dir*s.dims.y - 0.5f * s.dims.x * s.t - o, s.dims.z));
+	points.push_back(v3(s.p + s.dir*s.dims.y + 0.5f * s.dims.x * s.t - o, s.dims.z));
+	points.push_back(v3(s.p + s.dir*s.dims.y + 0.5f * s.dims.x * s.t - o, 0.0f));
+
+	// chunks for culling, each with a low detail version that skips rows of points
+	int segment_count = (int)segments.size();
+	std::vector<TrackVertex> vertices;
+	std::vector<u16> indices;
+	vertices.reserve((size_t)segment_count * 15);
+	indices.reserve((size_t)segment_count * 27);
+	chunks.clear();
+	const int group_segments = TRACK_MESH_CHUNK_SEGMENTS * TRACK_MESH_GROUP_CHUNKS;
+	for (int g = 0; g < segment_count; g += group_segments) {
+		int group_end = g + group_segments < segment_count ? g + group_segments : segment_count;
+		size_t group_first_chunk = chunks.size();
+		vec3 group_min = points[(size_t)(POINTS_PER_SEGMENT * g)];
+		vec3 group_max = group_min;
+		for (int a = g; a < group_end; a += TRACK_MESH_CHUNK_SEGMENTS) {
+			int b = a + TRACK_MESH_CHUNK_SEGMENTS < group_end ? a + TRACK_MESH_CHUNK_SEGMENTS : group_end;
+			TrackMeshChunk chunk;
+			chunk.min = chunk.max = points[(size_t)(POINTS_PER_SEGMENT * a)];
+			for (size_t i = (size_t)(POINTS_PER_SEGMENT * a); i < (size_t)(POINTS_PER_SEGMENT * (b+1)); i++) {
+				for (int k = 0; k < 3; k++) {
+					chunk.min.e[k] = fminf(chunk.min.e[k], points[i].e[k]);
+					chunk.max.e[k] = fmaxf(chunk.max.e[k], points[i].e[k]);
+				}
+			}
+			for (int k = 0; k < 3; k++) {
+				group_min.e[k] = fminf(group_min.e[k], chunk.min.e[k]);
+				group_max.e[k] = fmaxf(group_max.e[k], chunk.max.e[k]);
+			}
+			chunk.group = g / group_segments;
+			chunks.push_back(chunk);
+		}
+		vec3 origin = 0.5f * (group_min + group_max);
+		vec3 scale = 0.5f * (group_max - group_min);
+		for (int k = 0; k < 3; k++) scale.e[k] = fmaxf(scale.e[k], 0.001f);
+
+		int rows[TRACK_MESH_CHUNK_SEGMENTS + 1];
+		for (size_t ci = group_first_chunk; ci < chunks.size(); ci++) {
+			TrackMeshChunk &chunk = chunks[ci];
+			int a = g + TRACK_MESH_CHUNK_SEGMENTS * (int)(ci - group_first_chunk);
+			int b = a + TRACK_MESH_CHUNK_SEGMENTS < group_end ? a + TRACK_MESH_CHUNK_SEGMENTS : group_end;
+			int row_count = 0;
+			for (int r = a; r <= b; r++) rows[row_count++] = r;
+			chunk.origin = origin;
+			chunk.scale = scale;
+			chunk.first_index = (int)indices.size();
+			addTrackRows(points, rows, row_count, origin, scale, &vertices, &indices);
+			chunk.index_count = (int)indices.size() - chunk.first_index;
+		}
+		for (size_t ci = group_first_chunk; ci < chunks.size(); ci++) {
+			TrackMeshChunk &chunk = chunks[ci];
+			int a = g + TRACK_MESH_CHUNK_SEGMENTS * (int)(ci - group_first_chunk);
+			int b = a + TRACK_MESH_CHUNK_SEGMENTS < group_end ? a + TRACK_MESH_CHUNK_SEGMENTS : group_end;
+			int row_count = 0;
+			for (int r = a; r < b; r += TRACK_MESH_LOD_SEGMENTS) rows[row_count++] = r;
+			rows[row_count++] = b;
+			chunk.lod_first_index = (int)indices.size();
+			addTrackRows(points, rows, row_count, origin, scale, &vertices, &indices);
+			chunk.lod_index_count = (int)indices.size() - chunk.lod_first_index;
+		}
+	}
+	assert(vertices.size() <= 0x10000); // u16 indices
+
+	// track vertices, pickups, indices
+	vertex_count = (int)vertices.size();
+	size_t track_size = sizeof(TrackVertex) * vertices.size();
+	vertex_size = track_size + sizeof(float) * pickup_batch.build(track, o, nullptr);
+	index_size = sizeof(u16) * indices.size();
+	ARRAY_FREE(data);
+	data = new u8[vertex_size + index_size];
+	memcpy(data, &vertices[0], track_size);
+	pickup_batch.build(track, o, (float*)(data + track_size));
+	memcpy(data + vertex_size, &indices[0], index_size);
+
+	revision = track->revision;
+}
+
+bool TrackMesh::upload(size_t max_bytes) {
+	size_t size = vertex_size + index_size;
+	if (uploaded_revision == revision && uploaded_size == size) return true;
+
+	if (!vbo) glGenBuffers(1, &vbo);
+	if (!ibo) glGenBuffers(1, &ibo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+	if (uploaded_revision != revision) {
+		// new storage, so we don't wait on draws still using the old contents
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertex_size, nullptr, GL_STATIC_DRAW);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)index_size, nullptr, GL_STATIC_DRAW);
+		uploaded_revision = revision;
+		uploaded_size = 0;
+	}
+	size_t end = size - uploaded_size > max_bytes ? uploaded_size + max_bytes : size;
+	if (uploaded_size < vertex_size) {
+		size_t n = (end < vertex_size ? end : vertex_size) - uploaded_size;
+		glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)uploaded_size, (GLsizeiptr)n, data + uploaded_size);
+		uploaded_size += n;
+	}
+	if (uploaded_size < end) {
+		size_t n = end - uploaded_size;
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)(uploaded_size - vertex_size), (GLsizeiptr)n, data + uploaded_size);
+		uploaded_size += n;
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	if (uploaded_size < size) return false;
+	ARRAY_FREE(data); // the gpu has it now
+	return true;
+}
+
+void TrackMesh::destroy() {
+	ARRAY_FREE(data);
+	vertex_size = 0;
+	index_size = 0;
+	vertex_count = 0;
+	chunks.clear();
+	pickup_batch.destroy();
+	if (vbo) glDeleteBuffers(1, &vbo);
+	if (ibo) glDeleteBuffers(1, &ibo);
+	vbo = 0;
+	ibo = 0;
+	uploaded_revision = -1;
+	uploaded_size = 0;
+}
+
+void TrackMesh::getMemoryUsage(MemoryReport *report) {
+	size_t track_vertex_size = sizeof(TrackVertex) * (size_t)vertex_count;
+	bool on_gpu = uploaded_revision >= 0; // storage is allocated before the first slice is uploaded
+	report->add(MT_TRACK, sizeof(TrackMesh) + vectorBytes(chunks) + (data ? track_vertex_size + index_size : 0),
+		on_gpu ? track_vertex_size + index_size : 0);
+	report->add(MT_PICKUPS, data ? vertex_size - track_vertex_size : 0, on_gpu ? vertex_size - track_vertex_size : 0);
+	pickup_batch.getMemoryUsage(report);
+}
+
+// runs on the track generator's worker thread, see Game::initRender
+void Track::prepareMesh(Track *track) {
+	PROFILE_SCOPE("Track::prepareMesh");
+	if (!track->mesh) track->mesh = new TrackMesh();
+	track->mesh->build(track);
+}
+
+bool Track::uploadMesh(size_t max_bytes) {
+	if (segments.empty()) return true;
+
+	// build here if nobody prepared the mesh (e.g. debug regeneration)
+	if (!mesh) mesh = new TrackMesh();
+	if (mesh->revision != revision) mesh->build(this);
+	return mesh->upload(max_bytes);
+}
+
+void Track::getMeshMemoryUsage(MemoryReport *report) {
+	if (mesh) mesh->getMemoryUsage(report);
+}
+
+void Track::destroyMesh() {
+	if (!mesh) return;
+	mesh->destroy();
+	delete mesh;
+	mesh = nullptr;
+}
+
+const float TRACK_FOG_DISTANCE = 400.0f; // everything is black from here on, see the fragment shader
+const float TRACK_LOD_DISTANCE = 200.0f; // chunks further away than this are drawn in low detail
+
+// planes of the frustum with the far plane at the fog distance, inside: dot(plane, v4(p, 1)) >= 0
+// the projection's w is the distance along the view direction
+static void getCullingPlanes(mat4 mvp, vec4 planes[6]) {
+	vec4 rows[4];
+	for (int r = 0; r < 4; r++) rows[r] = v4(mvp.e[r], mvp.e[4+r], mvp.e[8+r], mvp.e[12+r]);
+	planes[0] = rows[3] + rows[0]; // left
+	planes[1] = rows[3] - rows[0]; // right
+	planes[2] = rows[3] + rows[1]; // bottom
+	planes[3] = rows[3] - rows[1]; // top
+	planes[4] = rows[3] + rows[2]; // near
+	planes[5] = v4(0.0f, 0.0f, 0.0f, TRACK_FOG_DISTANCE) - rows[3]; // fog
+}
+
+// smallest value of dot(plane, v4(p, 1)) for p in the box
+static float minPlaneDistance(vec4 plane, vec3 min, vec3 max) {
+	vec3 p = v3(plane.x < 0.0f ? max.x : min.x, plane.y < 0.0f ? max.y : min.y, plane.z < 0.0f ? max.z : min.z);
+	return plane.x*p.x + plane.y*p.y + plane.z*p.z + plane.w;
+}
+
+static void addTrackDraw(TrackMesh *mesh, mat4 mvp, const TrackMeshChunk *chunk, int first, int count, const float *color) {
+	mat4 chunk_mvp = mvp * translationMatrix(chunk->origin) * m4(scaleMatrix(chunk->scale));
+	RenderCommand *c = render_queue.add(RP_OPAQUE, track_program, 0, getViewDepth(mvp, 0.5f * (chunk->min + chunk->max)), count, first);
+	c->index_buffer = mesh->ibo;
+	render_queue.setAttrib(c, TR_VA_POSITION, mesh->vbo, 3, GL_SHORT, GL_TRUE, sizeof(TrackVertex), offsetof(TrackVertex, position));
+	render_queue.setAttrib(c, TR_VA_NORMAL, mesh->vbo, 4, GL_BYTE, GL_TRUE, sizeof(TrackVertex), offsetof(TrackVertex, normal));
+	render_queue.addUniform(c, track_color_loc, RU_VEC4, color);
+	render_queue.addUniform(c, track_mvp_loc, chunk_mvp);
+}
+
+// records the visible chunks, the pickups and the finish line into render_queue
+void Track::draw(mat4 view_proj_mat, float delta_time) {
+	if (segments.empty()) return;
+
+	// finish whatever wasn't uploaded ahead of time
+	uploadMesh(SIZE_MAX);
+
+	mat4 mvp = view_proj_mat * translationMatrix(v3(segments.front().p, 0.0f)); // mesh origin
+	const float color[4] = {0.9f, 0.85f, 0.6f, 1.0f};
+
+	// the visible chunks, neighbors of the same group and detail in one draw
+	vec4 planes[6];
+	getCullingPlanes(mvp, planes);
+	vec4 depth_plane = v4(mvp.e[3], mvp.e[7], mvp.e[11], mvp.e[15]);
+	const TrackMeshChunk *run_chunk = nullptr; // first one of the run
+	int run_first = 0, run_count = 0;
+	for (const TrackMeshChunk &chunk : mesh->chunks) {
+		bool visible = true;
+		for (int i = 0; i < 6 && visible; i++) {
+			visible = minPlaneDistance(planes[i], chunk.min, chunk.max) >= 0.0f;
+		}
+		if (!visible) continue;
+
+		bool far = minPlaneDistance(depth_plane, chunk.min, chunk.max) > TRACK_LOD_DISTANCE;
+		int first = far ? chunk.lod_first_index : chunk.first_index;
+		int count = far ? chunk.lod_index_count : chunk.index_count;
+		if (run_chunk && run_chunk->group == chunk.group && run_first + run_count == first) {
+			run_count += count;
+			continue;
+		}
+		if (run_chunk) addTrackDraw(mesh, mvp, run_chunk, run_first, run_count, color);
+		run_chunk = &chunk;
+		run_first = first;
+		run_count = count;
+	}
+	if (run_chunk) addTrackDraw(mesh, mvp, run_chunk, run_first, run_count, color);
+
+	// all the pickups, one draw per type
+	mesh->pickup_batch.draw(this, mesh->revision, mvp, mesh->vbo, sizeof(TrackVertex)*(size_t)mesh->vertex_count, delta_time);
+
+	if (!has_finish_line || finish_line_vertex_count == 0) return;
+
+	// the finish line
+	TrackSegment &s = segments.back();
+	mat4 model_mat = translationMatrix(v3(s.p, s.dims.z))
+		* m4(rotationMatrix(v3(0.0f, 0.0f, 1.0f), angleFromDir(s.dir) + 0.5f*(float)M_PI) 
+		* scaleMatrix(v3(0.5f*s.dims.x, 1.0f, 1.0f)));
+	RenderCommand *c = render_queue.add(RP_OPAQUE, finish_line_program, finish_line_texture,
+		getViewDepth(view_proj_mat, v3(s.p, s.dims.z)), finish_line_vertex_count);
+	GLsizei stride = STATIC_MESH_VERTEX_SIZE * sizeof(float);
+	render_queue.setAttrib(c, FL_VA_POSITION, finish_line_vbo, 3, GL_FLOAT, GL_FALSE, stride, 0);
+	render_queue.setAttrib(c, FL_VA_NORMAL, finish_line_vbo, 3, GL_FLOAT, GL_FALSE, stride, 3*sizeof(float));
+	render_queue.setAttrib(c, FL_VA_TEXCOORD, finish_line_vbo, 2, GL_FLOAT, GL_FALSE, stride, 6*sizeof(float));
+	render_queue.addUniform(c, finish_line_mvp_loc, view_proj_mat * model_mat);
+	render_queue.addUniform(c, finish_line_model_loc, model_mat);
+	render_queue.addUniform(c, finish_line_colormap_loc, 0);
+}
@@ -0,0 +1,42 @@
+const int TRACK_MESH_CHUNK_SEGMENTS = 8; // segments per culling chunk
+const int TRACK_MESH_LOD_SEGMENTS = 2; // segments merged into one in the low detail version
+const int TRACK_MESH_GROUP_CHUNKS = 4; // chunks quantized to the same bounds, so neighbors can be drawn together
+
+// compact vertex, positions are quantized to the bounds of their chunk's group
+struct TrackVertex {
+	s16 position[4]; // normalized, relative to TrackMeshChunk::origin and scale, w unused
+	s8 normal[4]; // normalized, w: 0 at the bottom of the walls, which fade into the abyss
+};
+
+// consecutive segments with their bounds, drawn or culled together
+// a group's chunks have their indices one after another, first all full and then all low detail ones
+struct TrackMeshChunk {
+	vec3 min, max; // relative to the mesh origin
+	vec3 origin, scale; // of the group, position = origin + scale * TrackVertex::position
+	int group;
+	int first_index, index_count;
+	int lod_first_index, lod_index_count; // merged segments for far away chunks
+};
+
+// gpu side of a track, attached to Track::mesh by the renderer
+struct TrackMesh {
+	int revision = -1; // Track::revision this mesh was built from
+
+	// track vertices, the pickup batch's vertices and then the track's u16 indices
+	// only kept until they are uploaded
+	u8 *data = nullptr;
+	size_t vertex_size = 0; // bytes for vbo
+	size_t index_size = 0; // bytes for ibo
+	int vertex_count = 0; // of the track, full and low detail
+	std::vector<TrackMeshChunk> chunks;
+	PickupBatch pickup_batch;
+	GLuint vbo = 0;
+	GLuint ibo = 0;
+	int uploaded_revision = -1; // revision currently being uploaded
+	size_t uploaded_size = 0; // bytes of data in vbo and ibo so far
+
+	void build(Track *track); // cpu only, safe on a worker thread
+	bool upload(size_t max_bytes); // uploads at most max_bytes, true when complete
+	void destroy();
+	void getMemoryUsage(MemoryReport *report);
+};